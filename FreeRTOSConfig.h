@@ -40,11 +40,18 @@
  * See http://www.freertos.org/a00110.html
  *----------------------------------------------------------*/
 
+/* Telemetry switches (TELEMETRY_ENABLE) and hooks */
+#include "telemetry.h"
+
 /* Scheduler Related */
 #define configUSE_PREEMPTION                    1
+/* Tickless idle is a separate opt-in (FREERTOS_TICKLESS_IDLE in CMakeLists.txt), not verified
+   with both cores of the RP2040 SMP port. The event-driven LVGL task does not need it */
+#ifndef configUSE_TICKLESS_IDLE
 #define configUSE_TICKLESS_IDLE                 0
+#endif
 #define configUSE_IDLE_HOOK                     0
-#define configUSE_TICK_HOOK                     1
+#define configUSE_TICK_HOOK                     0
 #define configTICK_RATE_HZ                      ( ( TickType_t ) 1000 )
 #define configMAX_PRIORITIES                    32
 #define configMINIMAL_STACK_SIZE                ( configSTACK_DEPTH_TYPE ) 256
@@ -75,12 +82,25 @@
 #define configAPPLICATION_ALLOCATED_HEAP        0
 
 /* Hook function related definitions. */
+/* Stack overflow checks (method 2) come with the telemetry, vApplicationStackOverflowHook() is in telemetry.c */
+#if TELEMETRY_ENABLE
+#define configCHECK_FOR_STACK_OVERFLOW          2
+#else
 #define configCHECK_FOR_STACK_OVERFLOW          0
+#endif
 #define configUSE_MALLOC_FAILED_HOOK            0
 #define configUSE_DAEMON_TASK_STARTUP_HOOK      0
 
 /* Run time and task stats gathering related definitions. */
+/* Task run time in microseconds of the RP2040 timer, idle time per core from the switch hook (telemetry.c) */
+#if TELEMETRY_ENABLE
+#define configGENERATE_RUN_TIME_STATS           1
+#define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS()
+#define portGET_RUN_TIME_COUNTER_VALUE()        telemetry_run_time_us()
+#define traceTASK_SWITCHED_IN()                 telemetry_task_switched_in()
+#else
 #define configGENERATE_RUN_TIME_STATS           0
+#endif
 #define configUSE_TRACE_FACILITY                1
 #define configUSE_STATS_FORMATTING_FUNCTIONS    0
 
@@ -0,0 +1,157 @@
+/**
+ * @file button_event.c
+ * @brief Deferred GPIO button events: the interrupt only timestamps and queues an edge,
+ *        a task dispatches it later
+ * @note The interrupt reads the 32-bit timer (one register) and writes one ring entry,
+ *       debouncing and LVGL calls happen in the handler at task level
+ * @author NIGHT
+ * @date 2025-10-27
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "button_event.h"
+#include "hardware/gpio.h"
+#include "hardware/sync.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define BUTTON_GPIO_COUNT           30
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void button_irq(uint gpio, uint32_t events);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static button_event_cb_t event_cb = NULL;
+static button_event_wake_cb_t event_wake_cb = NULL;
+
+/* Ring written by button_irq() only (head) and read by button_event_dispatch() only (tail) */
+static button_event_t ring[BUTTON_EVENT_QUEUE_SIZE];
+static volatile uint32_t ring_head = 0;
+static volatile uint32_t ring_tail = 0;
+
+/* Interrupt state: time of the last queued edge per GPIO, for merging bounces */
+static uint32_t last_edge_us[BUTTON_GPIO_COUNT];
+static bool last_edge_valid[BUTTON_GPIO_COUNT];
+
+static button_event_stats_t stats;
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+/**
+ * @brief Set the event handler
+ * @param cb Handler called by button_event_dispatch()
+ * @param wake_cb Called in interrupt context when an event was queued, or NULL
+ */
+void button_event_init(button_event_cb_t cb, button_event_wake_cb_t wake_cb)
+{
+    event_cb = cb;
+    event_wake_cb = wake_cb;
+}
+
+/**
+ * @brief Enable the edge interrupts of a button GPIO
+ * @param gpio GPIO number
+ * @param events GPIO_IRQ_EDGE_RISE and/or GPIO_IRQ_EDGE_FALL
+ */
+void button_event_add(uint gpio, uint32_t events)
+{
+    gpio_set_irq_enabled_with_callback(gpio, events, true, &button_irq);
+}
+
+/**
+ * @brief Hand all queued events to the handler
+ * @return Number of events dispatched
+ */
+uint32_t button_event_dispatch(void)
+{
+    uint32_t n = 0;
+
+    while (ring_tail != ring_head) {
+        __dmb();
+        button_event_t event = ring[ring_tail % BUTTON_EVENT_QUEUE_SIZE];
+        __dmb();
+        ring_tail++;
+
+        uint32_t latency = time_us_32() - event.t_us;
+        if (latency > stats.max_latency_us) {
+            stats.max_latency_us = latency;
+        }
+        if (event_cb != NULL) {
+            event_cb(&event);
+        }
+        n++;
+    }
+    return n;
+}
+
+/**
+ * @brief Get queue statistics
+ * @param out Output parameter: counters since the last reset
+ * @param reset Clear the counters after reading
+ */
+void button_event_get_stats(button_event_stats_t *out, bool reset)
+{
+    *out = stats;
+    if (reset) {
+        stats.queued = 0;
+        stats.merged = 0;
+        stats.dropped = 0;
+        stats.max_latency_us = 0;
+    }
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+/**
+ * @brief GPIO interrupt callback (shared gpio_set_irq_callback() of this core)
+ * @param gpio GPIO that raised the interrupt
+ * @param events Edges seen
+ * @note Interrupt context: no LVGL, no 64-bit time, no locks
+ */
+static void button_irq(uint gpio, uint32_t events)
+{
+    uint32_t now = time_us_32();
+
+    // 1. Bounce of an edge that is already queued
+    if (gpio < BUTTON_GPIO_COUNT) {
+        if (last_edge_valid[gpio] && now - last_edge_us[gpio] < BUTTON_EVENT_COALESCE_US) {
+            stats.merged++;
+            return;
+        }
+    }
+
+    // 2. Queue it, the handler sees the event in order after the ones before
+    if (ring_head - ring_tail >= BUTTON_EVENT_QUEUE_SIZE) {
+        stats.dropped++;
+        return;
+    }
+
+    button_event_t *e = &ring[ring_head % BUTTON_EVENT_QUEUE_SIZE];
+    e->gpio = gpio;
+    e->events = events;
+    e->t_us = now;
+    __dmb();
+    ring_head++;
+    stats.queued++;
+
+    if (gpio < BUTTON_GPIO_COUNT) {
+        last_edge_us[gpio] = now;
+        last_edge_valid[gpio] = true;
+    }
+
+    // 3. Let the dispatching task run
+    if (event_wake_cb != NULL) {
+        event_wake_cb();
+    }
+}
@@ -0,0 +1,108 @@
+/**
+ * @file button_event.h
+ * @brief Deferred GPIO button events: the interrupt only timestamps and queues an edge,
+ *        a task dispatches it later
+ * @note Single producer (GPIO interrupt of the core that added the buttons), single consumer
+ *       (the task calling button_event_dispatch()), lock-free
+ * @author NIGHT
+ * @date 2025-10-27
+ */
+
+#ifndef BUTTON_EVENT_H
+#define BUTTON_EVENT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdint.h>
+#include <stdbool.h>
+#include "pico/stdlib.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+/* Queued events (power of two) */
+#ifndef BUTTON_EVENT_QUEUE_SIZE
+#define BUTTON_EVENT_QUEUE_SIZE     16
+#endif
+
+/* Edges of one GPIO within this time after its last queued edge are merged into it (contact bounce) */
+#ifndef BUTTON_EVENT_COALESCE_US
+#define BUTTON_EVENT_COALESCE_US    2000
+#endif
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+/**
+ * @brief Button edge as seen by the interrupt
+ */
+typedef struct {
+    uint32_t gpio;
+    uint32_t events;            // GPIO_IRQ_EDGE_RISE / GPIO_IRQ_EDGE_FALL
+    uint32_t t_us;              // time_us_32() in the interrupt
+} button_event_t;
+
+/**
+ * @brief Event handler, called by button_event_dispatch() in task context
+ * @param event Event
+ */
+typedef void (*button_event_cb_t)(const button_event_t *event);
+
+/**
+ * @brief Wake-up of the dispatching task, called by the interrupt after queueing an event
+ */
+typedef void (*button_event_wake_cb_t)(void);
+
+/**
+ * @brief Queue statistics
+ */
+typedef struct {
+    uint32_t queued;            // Events queued by the interrupt
+    uint32_t merged;            // Bounce edges merged into a queued one
+    uint32_t dropped;           // Edges lost because the queue was full
+    uint32_t max_latency_us;    // Longest edge to dispatch time
+} button_event_stats_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+/**
+ * @brief Set the event handler
+ * @param cb Handler called by button_event_dispatch()
+ * @param wake_cb Called in interrupt context when an event was queued, NULL if the
+ *                dispatching task polls
+ */
+void button_event_init(button_event_cb_t cb, button_event_wake_cb_t wake_cb);
+
+/**
+ * @brief Enable the edge interrupts of a button GPIO
+ * @param gpio GPIO number (input, pulls as configured by the caller)
+ * @param events GPIO_IRQ_EDGE_RISE and/or GPIO_IRQ_EDGE_FALL
+ * @note The interrupt runs on the calling core
+ */
+void button_event_add(uint gpio, uint32_t events);
+
+/**
+ * @brief Hand all queued events to the handler
+ * @return Number of events dispatched
+ * @note Call from one task only
+ */
+uint32_t button_event_dispatch(void);
+
+/**
+ * @brief Get queue statistics
+ * @param out Output parameter: counters since the last reset
+ * @param reset Clear the counters after reading
+ */
+void button_event_get_stats(button_event_stats_t *out, bool reset);
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /*BUTTON_EVENT_H*/
@@ -25,9 +25,32 @@
  #define GT911_I2C_PORT          i2c0
  #define GT911_PIN_SDA           8
  #define GT911_PIN_SCL           9
- #define GT911_I2C_BAUDRATE      100000  // 100kHz
+ /* I2C clock: 100000, 400000 (default) or 1000000 (Fast-mode Plus, needs strong external pull-ups) */
+ #ifndef GT911_I2C_BAUDRATE
+ #define GT911_I2C_BAUDRATE      400000
+ #endif
+ 
+ /* Margin [us] added to the bus time of an I2C transaction (bytes x 9 bits at GT911_I2C_BAUDRATE)
+ * for its timeout, covers clock stretching; a stuck bus is then cleared (see i2c_dma.c) */
+ #ifndef GT911_I2C_TIMEOUT_US
+ #define GT911_I2C_TIMEOUT_US    5000
+ #endif
+ 
+ /* GT911 INT output (GPIO number), -1 if not wired: the driver is then polled */
+ #ifndef GT911_PIN_INT
+ #define GT911_PIN_INT           -1
+ #endif
  
  /* GT911 Register Addresses - from chip datasheet */
+ #define GT911_REG_CONFIG_VERSION    0x8047  // First byte of the config block
+ #define GT911_REG_X_OUTPUT_MAX_L    0x8048  // Config: X output range (low byte first)
+ #define GT911_REG_Y_OUTPUT_MAX_L    0x804A  // Config: Y output range
+ #define GT911_REG_MODULE_SWITCH1    0x804D  // Config: axis swap/reverse, bit1..0 INT trigger mode
+ #define GT911_REG_REFRESH_RATE      0x8056  // Config: bit3..0 report interval = 5 + N ms
+ #define GT911_REG_CONFIG_CHKSUM     0x80FF  // Two's complement of the sum of 0x8047-0x80FE
+ #define GT911_REG_CONFIG_FRESH      0x8100  // Write 1 to apply the new config
+ #define GT911_CONFIG_LEN            184     // 0x8047-0x80FE, covered by the checksum
+ 
  #define GT911_REG_PRODUCT_ID1       0x8140
  #define GT911_REG_PRODUCT_ID2       0x8141
  #define GT911_REG_PRODUCT_ID3       0x8142
@@ -39,6 +62,7 @@
  #define GT911_REG_Y_RES_L           0x8148  // Y resolution low byte
  #define GT911_REG_Y_RES_H           0x8149  // Y resolution high byte
  #define GT911_REG_VENDOR_ID         0x814A
+ #define GT911_INFO_LEN              11      // 0x8140-0x814A, read in one transaction
  
  #define GT911_REG_STATUS            0x814E  // Touch status register
  #define GT911_REG_TRACK_ID1         0x814F
@@ -48,6 +72,16 @@
  #define GT911_REG_PT1_Y_H           0x8153  // Touch point 1 Y coordinate high byte
  #define GT911_REG_PT1_SIZE_L        0x8154
  #define GT911_REG_PT1_SIZE_H        0x8155
+ #define GT911_REG_POINT1            0x814F  // First point record (track ID), records are 8 bytes
+ 
+ /* Point records */
+ #define GT911_POINT_SIZE            8
+ #define GT911_MAX_POINTS            5
+ 
+ /* Point records read together with the status byte. More touches cost one extra transaction */
+ #ifndef GT911_BURST_POINTS
+ #define GT911_BURST_POINTS          1
+ #endif
  
  /* Status Register Bit Definitions */
  #define GT911_STATUS_BUF_READY      0x80  // Data ready flag
@@ -56,6 +90,33 @@
  #define GT911_STATUS_HAVE_KEY       0x10
  #define GT911_STATUS_PT_MASK        0x0F  // Touch point count mask
  
+ /* Module Switch 1 axis bits */
+ #define GT911_SWITCH1_D_REVERSE     0x80  // Reverse the drive line axis
+ #define GT911_SWITCH1_S_REVERSE     0x40  // Reverse the sense line axis
+ #define GT911_SWITCH1_X2Y           0x08  // Swap X and Y
+ #define GT911_SWITCH1_AXES_MASK     (GT911_SWITCH1_D_REVERSE | GT911_SWITCH1_S_REVERSE | GT911_SWITCH1_X2Y)
+ 
+ /* Which reverse bit mirrors X and which Y depends on how the sensor is laid out on the panel */
+ #ifndef GT911_SWITCH1_X_REVERSE
+ #define GT911_SWITCH1_X_REVERSE     GT911_SWITCH1_D_REVERSE
+ #endif
+ #ifndef GT911_SWITCH1_Y_REVERSE
+ #define GT911_SWITCH1_Y_REVERSE     GT911_SWITCH1_S_REVERSE
+ #endif
+ 
+ /* Axis bits that make the reports match the panel in portrait orientation. The config is kept
+  * by the GT911 across resets, so the bits for other orientations are set relative to this */
+ #ifndef GT911_AXES_PORTRAIT
+ #define GT911_AXES_PORTRAIT         0x00
+ #endif
+ 
+ /* Module Switch 1 INT trigger modes */
+ #define GT911_INT_TRIGGER_MASK      0x03
+ #define GT911_INT_TRIGGER_RISING    0x00
+ #define GT911_INT_TRIGGER_FALLING   0x01
+ #define GT911_INT_TRIGGER_LOW       0x02
+ #define GT911_INT_TRIGGER_HIGH      0x03
+ 
  /**********************
   *      TYPEDEFS
   **********************/
@@ -68,8 +129,44 @@
      uint16_t max_x;                 // Maximum X coordinate
      uint16_t max_y;                 // Maximum Y coordinate
      uint8_t i2c_addr;               // I2C address
+     uint8_t int_trigger;            // INT trigger mode from the config (GT911_INT_TRIGGER_*)
  } gt911_dev_t;
  
+ /**
+  * @brief One tracked touch point
+  */
+ typedef struct {
+     uint8_t id;                     // Track ID, stays the same while the finger is down
+     uint16_t x;                     // X coordinate
+     uint16_t y;                     // Y coordinate
+     uint16_t size;                  // Contact size
+ } gt911_point_t;
+ 
+ /**
+  * @brief Touch report with all tracked points
+  */
+ typedef struct {
+     uint8_t count;                  // Number of valid points, 0 when released
+     gt911_point_t points[GT911_MAX_POINTS];
+ } gt911_touch_t;
+ 
+ /**
+  * @brief Coordinate mapping and report rate programmed into the GT911 config
+  */
+ typedef struct {
+     uint16_t x_max;                 // X output range (display width in this orientation)
+     uint16_t y_max;                 // Y output range
+     bool swap_xy;                   // Swap X and Y (landscape)
+     bool mirror_x;                  // Mirror X after the swap
+     bool mirror_y;                  // Mirror Y after the swap
+     uint8_t report_ms;              // Report interval, 5 to 20 ms
+ } gt911_config_t;
+ 
+ /**
+  * @brief INT callback, called from the GPIO IRQ when a new report is signalled
+  */
+ typedef void (*gt911_int_cb_t)(void);
+ 
  /**********************
   * FUNCTION PROTOTYPES
   **********************/
@@ -80,7 +177,15 @@
  bool gt911_init(void);
  
  /**
-  * @brief Read touch data
+  * @brief Read all tracked touch points
+  * @param touch Output parameter: points of the latest report
+  * @return true on success, false on failure
+  * @note If the GT911 has no new report yet, the previous one is returned
+  */
+ bool gt911_read_points(gt911_touch_t *touch);
+ 
+ /**
+  * @brief Read touch data (first touch point)
   * @param x Output parameter: X coordinate
   * @param y Output parameter: Y coordinate
   * @param pressed Output parameter: Touch state
@@ -88,10 +193,41 @@
   */
  bool gt911_read_touch(uint16_t *x, uint16_t *y, bool *pressed);
  
+ /**
+  * @brief Check whether the INT line is wired (GT911_PIN_INT >= 0)
+  * @return true if gt911_int_enable() can be used, false if the driver must be polled
+  */
+ bool gt911_int_available(void);
+ 
+ /**
+  * @brief Enable the INT line interrupt
+  * @param cb Callback for each report signalled by the GT911 (GPIO IRQ context)
+  * @return true on success, false if INT is not wired or the driver is not initialized
+  * @note The GPIO edge is chosen from the INT trigger mode in the GT911 config.
+  *       The IRQ is enabled on the calling core
+  */
+ bool gt911_int_enable(gt911_int_cb_t cb);
+ 
+ /**
+  * @brief Program resolution, axis mapping and report rate into the GT911 config (0x8047)
+  * @param cfg New settings
+  * @return true if the config is up to date, false on I2C failure
+  * @note Reads the config block, patches it, then writes it back with a new checksum and the
+  *       config fresh flag. Nothing is written if the settings are already in place
+  */
+ bool gt911_write_config(const gt911_config_t *cfg);
+ 
  /**
   * @brief Get device information (optional)
   * @return Pointer to device information structure
   */
  gt911_dev_t* gt911_get_dev_info(void);
  
+ /**
+  * @brief Get the number of reports read so far
+  * @return Report counter, incremented each time gt911_read_points() decodes a new report
+  * @note Compare before and after gt911_read_points() to tell a new report from the cached one
+  */
+ uint32_t gt911_get_report_count(void);
+ 
  #endif /* GT911_H */
\ No newline at end of file
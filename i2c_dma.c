@@ -0,0 +1,507 @@
+/**
+ * @file i2c_dma.c
+ * @brief Asynchronous I2C master: transaction queue driven by DMA and the I2C interrupt
+ * @note A transaction is one stream of IC_DATA_CMD words (data, read, RESTART and STOP bits)
+ *       fed by a TX DMA channel, while an RX DMA channel collects the read bytes. The I2C
+ *       interrupt finishes it at STOP_DET (or TX_ABRT), an alarm catches a stuck bus
+ * @author NIGHT
+ * @date 2025-10-27
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "i2c_dma.h"
+#include "hardware/dma.h"
+#include "hardware/gpio.h"
+#include "hardware/irq.h"
+#include "hardware/sync.h"
+#include "pico/stdlib.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+/* Bus clear: SCL pulses to free a target that holds SDA low (one byte plus ACK), at 100kHz */
+#define BUS_CLEAR_PULSES        9
+#define BUS_CLEAR_HALF_US       5
+
+/* Transaction slots: the running one plus I2C_DMA_QUEUE_SIZE waiting */
+#define QUEUE_SLOTS             (I2C_DMA_QUEUE_SIZE + 1)
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static bool i2c_dma_hw_init(void);
+static bool i2c_dma_valid(const i2c_dma_xfer_t *xfer);
+static void i2c_dma_start_next(void);
+static void i2c_dma_finish(i2c_dma_result_t result);
+static void i2c_dma_stop_dma(void);
+static void i2c_dma_bus_clear(void);
+static void i2c_dma_irq_handler(void);
+static int64_t i2c_dma_timeout_cb(alarm_id_t id, void *user_data);
+static void i2c_dma_sync_cb(i2c_dma_result_t result, void *user_data);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static i2c_inst_t *bus = NULL;
+static uint bus_sda;
+static uint bus_scl;
+static uint bus_baudrate;
+static int tx_chan = -1;
+static int rx_chan = -1;
+
+/* Guards the queue and the running transaction (submitters, I2C IRQ and timeout alarm) */
+static spin_lock_t *lock;
+
+/* Transaction queue, queue[queue_first] is the running one while active */
+static i2c_dma_xfer_t queue[QUEUE_SLOTS];
+static uint8_t queue_first = 0;
+static uint8_t queue_count = 0;
+static bool active = false;
+static i2c_dma_result_t active_result;   // Set at TX_ABRT, reported at STOP_DET
+static uint32_t active_seq = 0;          // Tells a stale timeout alarm from the current one
+static alarm_id_t timeout_alarm = 0;
+
+/* IC_DATA_CMD words of the running transaction */
+static uint16_t cmd_buf[I2C_DMA_MAX_LEN];
+
+static i2c_dma_stats_t stats = {0};
+
+/* i2c_dma_transfer(): one caller at a time, woken by the completion callback */
+static SemaphoreHandle_t sync_mutex = NULL;
+static SemaphoreHandle_t sync_done = NULL;
+static volatile bool sync_flag = false;
+static volatile i2c_dma_result_t sync_result;
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+/**
+ * @brief Initialize the I2C block, its DMA channels and interrupt
+ * @param i2c I2C instance (i2c0 or i2c1)
+ * @param pin_sda SDA GPIO
+ * @param pin_scl SCL GPIO
+ * @param baudrate Bus clock [Hz]
+ * @return true on success, false on failure
+ */
+bool i2c_dma_init(i2c_inst_t *i2c, uint pin_sda, uint pin_scl, uint baudrate)
+{
+    bus = i2c;
+    bus_sda = pin_sda;
+    bus_scl = pin_scl;
+    bus_baudrate = baudrate;
+    
+    // 1. Pins: the internal pull-ups (~50k) are only a backup for the board's external ones
+    gpio_pull_up(bus_sda);
+    gpio_pull_up(bus_scl);
+    
+    // 2. A target reset in the middle of a read can still hold SDA low
+    gpio_set_function(bus_sda, GPIO_FUNC_SIO);
+    gpio_set_dir(bus_sda, GPIO_IN);
+    sleep_us(BUS_CLEAR_HALF_US);
+    if (!gpio_get(bus_sda)) {
+        i2c_dma_bus_clear();
+    }
+    
+    if (!i2c_dma_hw_init()) {
+        return false;
+    }
+    
+    // 3. DMA: command words into IC_DATA_CMD, read bytes out of it
+    lock = spin_lock_init(spin_lock_claim_unused(true));
+    tx_chan = dma_claim_unused_channel(true);
+    rx_chan = dma_claim_unused_channel(true);
+    
+    dma_channel_config c = dma_channel_get_default_config(tx_chan);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_16);    // Data byte plus command bits
+    channel_config_set_read_increment(&c, true);
+    channel_config_set_write_increment(&c, false);
+    channel_config_set_dreq(&c, i2c_get_dreq(bus, true));
+    dma_channel_configure(tx_chan, &c, &i2c_get_hw(bus)->data_cmd, cmd_buf, 0, false);
+    
+    c = dma_channel_get_default_config(rx_chan);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_8);
+    channel_config_set_read_increment(&c, false);
+    channel_config_set_write_increment(&c, true);
+    channel_config_set_dreq(&c, i2c_get_dreq(bus, false));
+    dma_channel_configure(rx_chan, &c, NULL, &i2c_get_hw(bus)->data_cmd, 0, false);
+    
+    // 4. Interrupt: STOP_DET and TX_ABRT only (mask set in i2c_dma_hw_init())
+    uint irq = I2C0_IRQ + i2c_hw_index(bus);
+    irq_set_exclusive_handler(irq, i2c_dma_irq_handler);
+    irq_set_enabled(irq, true);
+    
+    // 5. Synchronous callers (created before the scheduler runs, used only after)
+    sync_mutex = xSemaphoreCreateMutex();
+    sync_done = xSemaphoreCreateBinary();
+    
+    return sync_mutex != NULL && sync_done != NULL;
+}
+
+/**
+ * @brief Queue a transaction
+ * @param xfer Transaction (copied, the buffers are not)
+ * @return true if queued, false if the queue is full or the transaction is invalid
+ */
+bool i2c_dma_submit(const i2c_dma_xfer_t *xfer)
+{
+    if (!i2c_dma_valid(xfer)) {
+        return false;
+    }
+    
+    uint32_t save = spin_lock_blocking(lock);
+    
+    if (queue_count >= QUEUE_SLOTS) {
+        spin_unlock(lock, save);
+        return false;
+    }
+    
+    queue[(queue_first + queue_count) % QUEUE_SLOTS] = *xfer;
+    queue_count++;
+    
+    if (!active) {
+        i2c_dma_start_next();
+    }
+    
+    spin_unlock(lock, save);
+    return true;
+}
+
+/**
+ * @brief Run a transaction and wait for its result
+ * @param addr 7-bit target address
+ * @param wr Bytes to write (NULL if wr_len is 0)
+ * @param wr_len Number of bytes to write
+ * @param rd Read buffer (NULL if rd_len is 0)
+ * @param rd_len Number of bytes to read
+ * @param timeout_us Transaction timeout, 0 for I2C_DMA_TIMEOUT_US
+ * @return Transaction result
+ */
+i2c_dma_result_t i2c_dma_transfer(uint8_t addr, const uint8_t *wr, uint16_t wr_len,
+                                  uint8_t *rd, uint16_t rd_len, uint32_t timeout_us)
+{
+    bool rtos = (xTaskGetSchedulerState() != taskSCHEDULER_NOT_STARTED);
+    i2c_dma_xfer_t xfer = {
+        .addr = addr,
+        .wr = wr,
+        .wr_len = wr_len,
+        .rd = rd,
+        .rd_len = rd_len,
+        .timeout_us = timeout_us,
+        .cb = i2c_dma_sync_cb,
+        .user_data = rtos ? sync_done : NULL,
+    };
+    
+    if (!i2c_dma_valid(&xfer)) {
+        return I2C_DMA_ERROR;
+    }
+    
+    if (rtos) {
+        xSemaphoreTake(sync_mutex, portMAX_DELAY);
+    }
+    
+    // 1. Queue it, waiting for a free slot behind asynchronous transactions
+    sync_flag = false;
+    while (!i2c_dma_submit(&xfer)) {
+        if (rtos) {
+            vTaskDelay(1);
+        } else {
+            tight_loop_contents();
+        }
+    }
+    
+    // 2. Wait for the callback: sleep in a task, spin before the scheduler runs
+    if (rtos) {
+        xSemaphoreTake(sync_done, portMAX_DELAY);
+    } else {
+        while (!sync_flag) {
+            tight_loop_contents();
+        }
+    }
+    i2c_dma_result_t result = sync_result;
+    
+    if (rtos) {
+        xSemaphoreGive(sync_mutex);
+    }
+    
+    return result;
+}
+
+/**
+ * @brief Get bus statistics
+ * @param out Output parameter: counters since init
+ */
+void i2c_dma_get_stats(i2c_dma_stats_t *out)
+{
+    uint32_t save = spin_lock_blocking(lock);
+    *out = stats;
+    spin_unlock(lock, save);
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+/**
+ * @brief (Re)start the I2C block in master mode and hand it the pins
+ * @return true on success, false if the baudrate cannot be set
+ * @note i2c_init() resets the block, which also clears the interrupt mask and FIFOs
+ */
+static bool i2c_dma_hw_init(void)
+{
+    uint actual_baudrate = i2c_init(bus, bus_baudrate);
+    i2c_get_hw(bus)->intr_mask = I2C_IC_INTR_MASK_M_STOP_DET_BITS | I2C_IC_INTR_MASK_M_TX_ABRT_BITS;
+    
+    gpio_set_function(bus_sda, GPIO_FUNC_I2C);
+    gpio_set_function(bus_scl, GPIO_FUNC_I2C);
+    
+    return actual_baudrate != 0;
+}
+
+/**
+ * @brief Check a transaction before queueing it
+ * @param xfer Transaction
+ * @return true if it can be run
+ */
+static bool i2c_dma_valid(const i2c_dma_xfer_t *xfer)
+{
+    if (bus == NULL || xfer == NULL) {
+        return false;
+    }
+    if ((xfer->wr_len > 0 && xfer->wr == NULL) || (xfer->rd_len > 0 && xfer->rd == NULL)) {
+        return false;
+    }
+    
+    uint32_t len = (uint32_t)xfer->wr_len + xfer->rd_len;
+    return len > 0 && len <= I2C_DMA_MAX_LEN;
+}
+
+/**
+ * @brief Start the first queued transaction
+ * @note Called with lock held. Clears active when the queue is empty
+ */
+static void i2c_dma_start_next(void)
+{
+    if (queue_count == 0) {
+        active = false;
+        return;
+    }
+    
+    const i2c_dma_xfer_t *x = &queue[queue_first];
+    i2c_hw_t *hw = i2c_get_hw(bus);
+    
+    // 1. Target address, only writable while the block is disabled
+    if (hw->tar != x->addr) {
+        hw->enable = 0;
+        hw->tar = x->addr;
+        hw->enable = 1;
+    }
+    
+    // 2. Command words: written bytes, then read commands (RESTART on the first), STOP on the last
+    uint16_t n = 0;
+    for (uint16_t i = 0; i < x->wr_len; i++) {
+        cmd_buf[n++] = x->wr[i];
+    }
+    for (uint16_t i = 0; i < x->rd_len; i++) {
+        cmd_buf[n++] = I2C_IC_DATA_CMD_CMD_BITS |
+                       ((i == 0 && x->wr_len > 0) ? I2C_IC_DATA_CMD_RESTART_BITS : 0);
+    }
+    cmd_buf[n - 1] |= I2C_IC_DATA_CMD_STOP_BITS;
+    
+    // 3. Start: RX channel first so no read byte is missed
+    (void)hw->clr_intr;
+    active = true;
+    active_result = I2C_DMA_OK;
+    active_seq++;
+    
+    if (x->rd_len > 0) {
+        dma_channel_transfer_to_buffer_now(rx_chan, x->rd, x->rd_len);
+    }
+    dma_channel_transfer_from_buffer_now(tx_chan, cmd_buf, n);
+    
+    uint32_t timeout = x->timeout_us ? x->timeout_us : I2C_DMA_TIMEOUT_US;
+    timeout_alarm = add_alarm_in_us(timeout, i2c_dma_timeout_cb, (void *)(uintptr_t)active_seq, true);
+}
+
+/**
+ * @brief Retire the running transaction and start the next one
+ * @param result Result of the running transaction
+ * @note Called with lock held. The caller copies the transaction first to call its callback
+ *       after releasing the lock
+ */
+static void i2c_dma_finish(i2c_dma_result_t result)
+{
+    if (timeout_alarm > 0) {
+        cancel_alarm(timeout_alarm);
+    }
+    timeout_alarm = 0;
+    
+    stats.transfers++;
+    if (result == I2C_DMA_NACK) {
+        stats.nacks++;
+    } else if (result == I2C_DMA_TIMEOUT) {
+        stats.timeouts++;
+    }
+    
+    queue_first = (queue_first + 1) % QUEUE_SLOTS;
+    queue_count--;
+    
+    i2c_dma_start_next();
+}
+
+/**
+ * @brief Stop both DMA channels
+ */
+static void i2c_dma_stop_dma(void)
+{
+    dma_channel_abort(tx_chan);
+    dma_channel_abort(rx_chan);
+}
+
+/**
+ * @brief Free a bus held by a target and restart the I2C block
+ * @note SCL is pulsed until the target releases SDA, then a STOP is sent. The pins are driven
+ *       open-drain style: output low, or input released to the pull-up
+ */
+static void i2c_dma_bus_clear(void)
+{
+    // 1. Take the pins over as GPIOs
+    gpio_set_function(bus_sda, GPIO_FUNC_SIO);
+    gpio_set_function(bus_scl, GPIO_FUNC_SIO);
+    gpio_put(bus_sda, 0);
+    gpio_put(bus_scl, 0);
+    gpio_set_dir(bus_sda, GPIO_IN);
+    gpio_set_dir(bus_scl, GPIO_IN);
+    busy_wait_us(BUS_CLEAR_HALF_US);
+    
+    // 2. Clock out whatever the target is still sending
+    for (uint8_t i = 0; i < BUS_CLEAR_PULSES && !gpio_get(bus_sda); i++) {
+        gpio_set_dir(bus_scl, GPIO_OUT);
+        busy_wait_us(BUS_CLEAR_HALF_US);
+        gpio_set_dir(bus_scl, GPIO_IN);
+        busy_wait_us(BUS_CLEAR_HALF_US);
+    }
+    
+    // 3. STOP: SDA rises while SCL is high
+    gpio_set_dir(bus_scl, GPIO_OUT);
+    busy_wait_us(BUS_CLEAR_HALF_US);
+    gpio_set_dir(bus_sda, GPIO_OUT);
+    busy_wait_us(BUS_CLEAR_HALF_US);
+    gpio_set_dir(bus_scl, GPIO_IN);
+    busy_wait_us(BUS_CLEAR_HALF_US);
+    gpio_set_dir(bus_sda, GPIO_IN);
+    busy_wait_us(BUS_CLEAR_HALF_US);
+    
+    // 4. Fresh I2C block
+    (void)i2c_dma_hw_init();
+    stats.bus_clears++;
+}
+
+/**
+ * @brief I2C interrupt handler: STOP_DET ends a transaction, TX_ABRT marks it failed
+ * @note After an abort the block still sends a STOP, so the transaction ends at STOP_DET
+ *       in both cases. Without a STOP (arbitration lost) the timeout ends it
+ */
+static void i2c_dma_irq_handler(void)
+{
+    i2c_hw_t *hw = i2c_get_hw(bus);
+    i2c_dma_xfer_t done;
+    i2c_dma_result_t result = I2C_DMA_OK;
+    bool finished = false;
+    
+    uint32_t save = spin_lock_blocking(lock);
+    uint32_t stat = hw->intr_stat;
+    
+    // 1. Abort: the block flushes the TX FIFO until TX_ABRT is cleared
+    if (stat & I2C_IC_INTR_STAT_R_TX_ABRT_BITS) {
+        uint32_t source = hw->tx_abrt_source;
+        i2c_dma_stop_dma();
+        (void)hw->clr_tx_abrt;
+    
+        if (active && active_result == I2C_DMA_OK) {
+            bool nack = source & (I2C_IC_TX_ABRT_SOURCE_ABRT_7B_ADDR_NOACK_BITS |
+                                  I2C_IC_TX_ABRT_SOURCE_ABRT_TXDATA_NOACK_BITS);
+            active_result = nack ? I2C_DMA_NACK : I2C_DMA_ERROR;
+        }
+    }
+    
+    // 2. STOP on the bus: the transaction is over
+    if (stat & I2C_IC_INTR_STAT_R_STOP_DET_BITS) {
+        (void)hw->clr_stop_det;
+    
+        if (active) {
+            // The last read byte can still be on its way out of the RX FIFO
+            while (active_result == I2C_DMA_OK && dma_channel_is_busy(rx_chan)) {
+                tight_loop_contents();
+            }
+    
+            done = queue[queue_first];
+            result = active_result;
+            finished = true;
+            i2c_dma_finish(result);
+        }
+    }
+    
+    spin_unlock(lock, save);
+    
+    if (finished && done.cb != NULL) {
+        done.cb(result, done.user_data);
+    }
+}
+
+/**
+ * @brief Transaction timeout: clear the bus and fail the transaction
+ * @param id Alarm ID
+ * @param user_data Sequence number of the transaction the alarm was set for
+ * @return 0 (no repeat)
+ */
+static int64_t i2c_dma_timeout_cb(alarm_id_t id, void *user_data)
+{
+    i2c_dma_xfer_t done;
+    
+    (void)id;
+    
+    uint32_t save = spin_lock_blocking(lock);
+    
+    // Finished (or replaced) while this alarm was already firing
+    if (!active || (uint32_t)(uintptr_t)user_data != active_seq) {
+        spin_unlock(lock, save);
+        return 0;
+    }
+    
+    timeout_alarm = 0;  // Firing now, nothing to cancel
+    i2c_dma_stop_dma();
+    i2c_dma_bus_clear();
+    
+    done = queue[queue_first];
+    i2c_dma_finish(I2C_DMA_TIMEOUT);
+    
+    spin_unlock(lock, save);
+    
+    if (done.cb != NULL) {
+        done.cb(I2C_DMA_TIMEOUT, done.user_data);
+    }
+    return 0;
+}
+
+/**
+ * @brief Completion callback of i2c_dma_transfer()
+ * @param result Transaction result
+ * @param user_data Semaphore to give, NULL before the scheduler runs
+ */
+static void i2c_dma_sync_cb(i2c_dma_result_t result, void *user_data)
+{
+    sync_result = result;
+    sync_flag = true;
+    
+    if (user_data != NULL) {
+        BaseType_t woken = pdFALSE;
+        xSemaphoreGiveFromISR((SemaphoreHandle_t)user_data, &woken);
+        portYIELD_FROM_ISR(woken);
+    }
+}
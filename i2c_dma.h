@@ -0,0 +1,133 @@
+/**
+ * @file i2c_dma.h
+ * @brief Asynchronous I2C master: transaction queue driven by DMA and the I2C interrupt
+ * @note One instance (one I2C block). Transfers never busy-wait on the bus, a stuck
+ *       transaction times out and the bus is cleared
+ * @author NIGHT
+ * @date 2025-10-27
+ */
+
+#ifndef I2C_DMA_H
+#define I2C_DMA_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdint.h>
+#include <stdbool.h>
+#include "hardware/i2c.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+/* Longest transaction (write + read bytes), sets the size of the DMA command buffer */
+#ifndef I2C_DMA_MAX_LEN
+#define I2C_DMA_MAX_LEN         192
+#endif
+
+/* Transactions that can wait behind the running one */
+#ifndef I2C_DMA_QUEUE_SIZE
+#define I2C_DMA_QUEUE_SIZE      4
+#endif
+
+/* Timeout of a transaction when none is given [us] */
+#ifndef I2C_DMA_TIMEOUT_US
+#define I2C_DMA_TIMEOUT_US      10000
+#endif
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+/**
+ * @brief Transaction result
+ */
+typedef enum {
+    I2C_DMA_OK = 0,
+    I2C_DMA_NACK,           // Address or data byte not acknowledged
+    I2C_DMA_TIMEOUT,        // Not finished in time, the bus has been cleared
+    I2C_DMA_ERROR,          // Arbitration lost or invalid transaction
+} i2c_dma_result_t;
+
+/**
+ * @brief Transaction complete callback
+ * @note Called from interrupt context (I2C or timer IRQ)
+ */
+typedef void (*i2c_dma_cb_t)(i2c_dma_result_t result, void *user_data);
+
+/**
+ * @brief One transaction: write wr_len bytes, then (repeated start) read rd_len bytes
+ * @note The buffers must stay valid until the callback has been called
+ */
+typedef struct {
+    uint8_t addr;           // 7-bit target address
+    const uint8_t *wr;      // Bytes to write (NULL if wr_len is 0)
+    uint16_t wr_len;
+    uint8_t *rd;            // Read buffer (NULL if rd_len is 0)
+    uint16_t rd_len;
+    uint32_t timeout_us;    // 0: I2C_DMA_TIMEOUT_US
+    i2c_dma_cb_t cb;        // Completion callback, may be NULL
+    void *user_data;
+} i2c_dma_xfer_t;
+
+/**
+ * @brief Bus statistics
+ */
+typedef struct {
+    uint32_t transfers;     // Transactions finished (any result)
+    uint32_t nacks;
+    uint32_t timeouts;
+    uint32_t bus_clears;    // Bus recoveries (SCL pulses and STOP)
+} i2c_dma_stats_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+/**
+ * @brief Initialize the I2C block, its DMA channels and interrupt
+ * @param i2c I2C instance (i2c0 or i2c1)
+ * @param pin_sda SDA GPIO
+ * @param pin_scl SCL GPIO
+ * @param baudrate Bus clock [Hz]
+ * @return true on success, false on failure
+ * @note The interrupt is enabled on the calling core
+ */
+bool i2c_dma_init(i2c_inst_t *i2c, uint pin_sda, uint pin_scl, uint baudrate);
+
+/**
+ * @brief Queue a transaction
+ * @param xfer Transaction (copied, the buffers are not)
+ * @return true if queued, false if the queue is full or the transaction is invalid
+ * @note Can be called from any context, including the completion callback
+ */
+bool i2c_dma_submit(const i2c_dma_xfer_t *xfer);
+
+/**
+ * @brief Run a transaction and wait for its result
+ * @param addr 7-bit target address
+ * @param wr Bytes to write (NULL if wr_len is 0)
+ * @param wr_len Number of bytes to write
+ * @param rd Read buffer (NULL if rd_len is 0)
+ * @param rd_len Number of bytes to read
+ * @param timeout_us Transaction timeout, 0 for I2C_DMA_TIMEOUT_US
+ * @return Transaction result
+ * @note In a task the caller blocks (other tasks run), before the scheduler is started it spins.
+ *       Not for interrupt context, use i2c_dma_submit() there
+ */
+i2c_dma_result_t i2c_dma_transfer(uint8_t addr, const uint8_t *wr, uint16_t wr_len,
+                                  uint8_t *rd, uint16_t rd_len, uint32_t timeout_us);
+
+/**
+ * @brief Get bus statistics
+ * @param out Output parameter: counters since init
+ */
+void i2c_dma_get_stats(i2c_dma_stats_t *out);
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /*I2C_DMA_H*/
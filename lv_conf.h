@@ -29,7 +29,8 @@
 #define LV_COLOR_DEPTH 16
 
 /*Swap the 2 bytes of RGB565 color. Useful if the display has an 8-bit interface (e.g. SPI)*/
-#define LV_COLOR_16_SWAP 1
+/*Not needed here: st7796.c sends pixels as 16-bit SPI frames, so LVGL renders in native order*/
+#define LV_COLOR_16_SWAP 0
 
 //#define LV_COLOR_CHROMA_KEY lv_color_hex(0x00ff00)
 
@@ -91,10 +92,10 @@
 
 /*Use a custom tick source that tells the elapsed time in milliseconds.
  *It removes the need to manually update the tick with `lv_tick_inc()`)*/
-#define LV_TICK_CUSTOM 0
+#define LV_TICK_CUSTOM 1
 #if LV_TICK_CUSTOM
-    #define LV_TICK_CUSTOM_INCLUDE "Arduino.h"         /*Header for the system time function*/
-    #define LV_TICK_CUSTOM_SYS_TIME_EXPR (millis())    /*Expression evaluating to current system time in ms*/
+    #define LV_TICK_CUSTOM_INCLUDE "lv_port_tick.h"          /*Header for the system time function*/
+    #define LV_TICK_CUSTOM_SYS_TIME_EXPR (lv_port_tick_get())  /*RP2040 64-bit timer, see lv_port_tick.c*/
     /*If using lvgl as ESP32 component*/
     // #define LV_TICK_CUSTOM_INCLUDE "esp_timer.h"
     // #define LV_TICK_CUSTOM_SYS_TIME_EXPR ((esp_timer_get_time() / 1000LL))
@@ -374,11 +375,16 @@
 
 /*Montserrat fonts with ASCII range and some symbols using bpp = 4
  *https://fonts.google.com/specimen/Montserrat*/
+/*14 and 16 are replaced by subsets generated at build time (tools/font_subset.py),
+ *set by CMake (LV_PORT_FONT_SUBSET)*/
+#ifndef LV_PORT_FONT_SUBSET
+    #define LV_PORT_FONT_SUBSET 0
+#endif
 #define LV_FONT_MONTSERRAT_8  0
 #define LV_FONT_MONTSERRAT_10 0
 #define LV_FONT_MONTSERRAT_12 1
-#define LV_FONT_MONTSERRAT_14 1
-#define LV_FONT_MONTSERRAT_16 1
+#define LV_FONT_MONTSERRAT_14 (!LV_PORT_FONT_SUBSET)
+#define LV_FONT_MONTSERRAT_16 (!LV_PORT_FONT_SUBSET)
 #define LV_FONT_MONTSERRAT_18 0
 #define LV_FONT_MONTSERRAT_20 0
 #define LV_FONT_MONTSERRAT_22 0
@@ -409,7 +415,11 @@
 /*Optionally declare custom fonts here.
  *You can use these fonts as default font too and they will be available globally.
  *E.g. #define LV_FONT_CUSTOM_DECLARE   LV_FONT_DECLARE(my_font_1) LV_FONT_DECLARE(my_font_2)*/
-#define LV_FONT_CUSTOM_DECLARE
+#if LV_PORT_FONT_SUBSET
+    #define LV_FONT_CUSTOM_DECLARE LV_FONT_DECLARE(lv_font_montserrat_14) LV_FONT_DECLARE(lv_font_montserrat_16)
+#else
+    #define LV_FONT_CUSTOM_DECLARE
+#endif
 
 /*Always set a default font*/
 #define LV_FONT_DEFAULT &lv_font_montserrat_14
@@ -0,0 +1,261 @@
+/**
+ * @file lv_port_cmd.c
+ * @brief LVGL UI Command Queue: other tasks post UI changes, the LVGL task applies them
+ * @note The ring is guarded by a hardware spin lock held for a few instructions, never
+ *       across LVGL calls, so a producer on core 0 does not wait for a render on core 1.
+ *       Wake-ups are FreeRTOS task notifications to the task sleeping in lv_port_cmd_wait()
+ * @author NIGHT
+ * @date 2025-10-27
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "lv_port_cmd.h"
+#include "pico/stdlib.h"
+#include "hardware/sync.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include <string.h>
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef enum {
+    CMD_SET_POS,
+    CMD_SET_TEXT,
+    CMD_LED_TOGGLE,
+} cmd_type_t;
+
+/**
+ * @brief Queued command
+ */
+typedef struct {
+    cmd_type_t type;
+    lv_obj_t * obj;
+    union {
+        struct {
+            lv_coord_t x;
+            lv_coord_t y;
+        } pos;
+        char text[LV_PORT_CMD_TEXT_MAX];
+    } arg;
+} cmd_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static bool cmd_post(const cmd_t * cmd, bool coalesce);
+static void cmd_apply(const cmd_t * cmd);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static spin_lock_t * cmd_lock;
+static cmd_t cmd_ring[LV_PORT_CMD_QUEUE_SIZE];
+static uint32_t cmd_head = 0;       // Next free slot, guarded by cmd_lock
+static uint32_t cmd_tail = 0;       // Oldest pending command, guarded by cmd_lock
+static TaskHandle_t cmd_waiter = NULL;  // LVGL task, set by its first lv_port_cmd_wait()
+static lv_port_cmd_stats_t stats;
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+/**
+ * @brief Initialize the command queue
+ */
+void lv_port_cmd_init(void)
+{
+    cmd_lock = spin_lock_init(spin_lock_claim_unused(true));
+}
+
+/**
+ * @brief Move an object (lv_obj_set_pos())
+ * @param obj Object
+ * @param x New x coordinate
+ * @param y New y coordinate
+ * @return false if the queue was full
+ */
+bool lv_port_cmd_set_pos(lv_obj_t * obj, lv_coord_t x, lv_coord_t y)
+{
+    cmd_t cmd = { .type = CMD_SET_POS, .obj = obj };
+    cmd.arg.pos.x = x;
+    cmd.arg.pos.y = y;
+    return cmd_post(&cmd, true);
+}
+
+/**
+ * @brief Set the text of a label (lv_label_set_text())
+ * @param label Label
+ * @param text Text, copied (at most LV_PORT_CMD_TEXT_MAX - 1 characters)
+ * @return false if the queue was full
+ */
+bool lv_port_cmd_set_text(lv_obj_t * label, const char * text)
+{
+    cmd_t cmd = { .type = CMD_SET_TEXT, .obj = label };
+    strncpy(cmd.arg.text, text, LV_PORT_CMD_TEXT_MAX - 1);
+    cmd.arg.text[LV_PORT_CMD_TEXT_MAX - 1] = '\0';
+    return cmd_post(&cmd, true);
+}
+
+/**
+ * @brief Toggle an LED widget (lv_led_toggle())
+ * @param led LED
+ * @return false if the queue was full
+ */
+bool lv_port_cmd_led_toggle(lv_obj_t * led)
+{
+    // Not coalesced: two toggles must both be applied
+    cmd_t cmd = { .type = CMD_LED_TOGGLE, .obj = led };
+    return cmd_post(&cmd, false);
+}
+
+/**
+ * @brief Apply all queued commands
+ * @note The pending commands are copied out in one go, so producers are only held off
+ *       for the copy and not while LVGL invalidates and lays out the objects
+ */
+void lv_port_cmd_process(void)
+{
+    cmd_t batch[LV_PORT_CMD_QUEUE_SIZE];
+    uint32_t n = 0;
+
+    // 1. Take the whole queue
+    uint32_t save = spin_lock_blocking(cmd_lock);
+    while (cmd_tail != cmd_head) {
+        batch[n++] = cmd_ring[cmd_tail % LV_PORT_CMD_QUEUE_SIZE];
+        cmd_tail++;
+    }
+    spin_unlock(cmd_lock, save);
+
+    // 2. Apply it in posting order
+    for (uint32_t i = 0; i < n; i++) {
+        cmd_apply(&batch[i]);
+    }
+    if (n > stats.max_batch) {
+        stats.max_batch = n;
+    }
+}
+
+/**
+ * @brief Sleep until woken or until the next LVGL timer is due (LVGL task)
+ * @param timeout_ms Return value of lv_timer_handler() (LV_NO_TIMER_READY if no timer runs)
+ * @note A wake-up given while the task was busy is kept by the notification count, so the
+ *       next call returns at once
+ */
+void lv_port_cmd_wait(uint32_t timeout_ms)
+{
+    if (cmd_waiter == NULL) {
+        cmd_waiter = xTaskGetCurrentTaskHandle();
+    }
+
+    if (timeout_ms > LV_PORT_CMD_MAX_WAIT_MS) {
+        timeout_ms = LV_PORT_CMD_MAX_WAIT_MS;
+    }
+    if (ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(timeout_ms)) != 0) {
+        stats.wakeups++;
+    }
+}
+
+/**
+ * @brief Wake the LVGL task from lv_port_cmd_wait()
+ */
+void lv_port_cmd_wake(void)
+{
+    TaskHandle_t task = cmd_waiter;
+    if (task == NULL) {
+        return;     // Polling mode, or the LVGL task has not slept yet
+    }
+
+    if (__get_current_exception() != 0) {
+        BaseType_t woken = pdFALSE;
+        vTaskNotifyGiveFromISR(task, &woken);
+        portYIELD_FROM_ISR(woken);
+    } else {
+        xTaskNotifyGive(task);
+    }
+}
+
+/**
+ * @brief Get command queue statistics
+ * @param out Output parameter: counters since the last reset
+ * @param reset Clear the counters after reading
+ */
+void lv_port_cmd_get_stats(lv_port_cmd_stats_t * out, bool reset)
+{
+    *out = stats;
+    if (reset) {
+        stats.posted = 0;
+        stats.coalesced = 0;
+        stats.dropped = 0;
+        stats.max_batch = 0;
+        stats.wakeups = 0;
+    }
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+/**
+ * @brief Queue a command
+ * @param cmd Command, copied
+ * @param coalesce Replace a pending command of the same type for the same object
+ * @return false if the queue was full
+ * @note Callable from any task on either core, and from interrupts (the lock masks them)
+ */
+static bool cmd_post(const cmd_t * cmd, bool coalesce)
+{
+    bool ok = true;
+    uint32_t save = spin_lock_blocking(cmd_lock);
+
+    // 1. Newer value for a command still waiting: overwrite it in place
+    if (coalesce) {
+        for (uint32_t i = cmd_tail; i != cmd_head; i++) {
+            cmd_t * pending = &cmd_ring[i % LV_PORT_CMD_QUEUE_SIZE];
+            if (pending->type == cmd->type && pending->obj == cmd->obj) {
+                *pending = *cmd;
+                stats.coalesced++;
+                spin_unlock(cmd_lock, save);
+                return true;    // Already pending, the LVGL task has been woken for it
+            }
+        }
+    }
+
+    // 2. Otherwise append
+    if (cmd_head - cmd_tail < LV_PORT_CMD_QUEUE_SIZE) {
+        cmd_ring[cmd_head % LV_PORT_CMD_QUEUE_SIZE] = *cmd;
+        cmd_head++;
+        stats.posted++;
+    } else {
+        stats.dropped++;
+        ok = false;
+    }
+
+    spin_unlock(cmd_lock, save);
+
+    if (ok) {
+        lv_port_cmd_wake();
+    }
+    return ok;
+}
+
+/**
+ * @brief Apply one command (LVGL task)
+ * @param cmd Command
+ */
+static void cmd_apply(const cmd_t * cmd)
+{
+    switch (cmd->type) {
+    case CMD_SET_POS:
+        lv_obj_set_pos(cmd->obj, cmd->arg.pos.x, cmd->arg.pos.y);
+        break;
+    case CMD_SET_TEXT:
+        lv_label_set_text(cmd->obj, cmd->arg.text);
+        break;
+    case CMD_LED_TOGGLE:
+        lv_led_toggle(cmd->obj);
+        break;
+    }
+}
@@ -0,0 +1,127 @@
+/**
+ * @file lv_port_cmd.h
+ * @brief LVGL UI Command Queue: other tasks post UI changes, the LVGL task applies them
+ * @note LVGL is only called from the LVGL task. Producers never wait for a frame to finish.
+ *       In event-driven mode the LVGL task sleeps in lv_port_cmd_wait() between frames
+ * @author NIGHT
+ * @date 2025-10-27
+ */
+
+#ifndef LV_PORT_CMD_H
+#define LV_PORT_CMD_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#if defined(LV_LVGL_H_INCLUDE_SIMPLE)
+#include "lvgl.h"
+#else
+#include "lvgl/lvgl.h"
+#endif
+#include <stdbool.h>
+
+/*********************
+ *      DEFINES
+ *********************/
+/* Event-driven LVGL task: sleep until the next LVGL timer or a wake-up instead of polling */
+#ifndef LV_PORT_EVENT_DRIVEN
+#define LV_PORT_EVENT_DRIVEN        0
+#endif
+
+/* Longest sleep in lv_port_cmd_wait() [ms] */
+#ifndef LV_PORT_CMD_MAX_WAIT_MS
+#define LV_PORT_CMD_MAX_WAIT_MS     1000
+#endif
+
+/* Pending commands (power of two). A full queue makes lv_port_cmd_*() return false */
+#ifndef LV_PORT_CMD_QUEUE_SIZE
+#define LV_PORT_CMD_QUEUE_SIZE      16
+#endif
+
+/* Longest text of lv_port_cmd_set_text(), including the terminator; longer texts are cut */
+#define LV_PORT_CMD_TEXT_MAX        32
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+/**
+ * @brief Command queue statistics
+ */
+typedef struct {
+    uint32_t posted;            // Commands queued
+    uint32_t coalesced;         // Commands that replaced a pending one for the same object
+    uint32_t dropped;           // Commands rejected because the queue was full
+    uint32_t max_batch;         // Most commands applied before one frame
+    uint32_t wakeups;           // lv_port_cmd_wait() returns because of lv_port_cmd_wake()
+} lv_port_cmd_stats_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+/**
+ * @brief Initialize the command queue
+ * @note Call before any task posts a command
+ */
+void lv_port_cmd_init(void);
+
+/**
+ * @brief Move an object (lv_obj_set_pos())
+ * @param obj Object
+ * @param x New x coordinate
+ * @param y New y coordinate
+ * @return false if the queue was full
+ * @note A pending move of the same object is replaced, only the latest position is applied
+ */
+bool lv_port_cmd_set_pos(lv_obj_t * obj, lv_coord_t x, lv_coord_t y);
+
+/**
+ * @brief Set the text of a label (lv_label_set_text())
+ * @param label Label
+ * @param text Text, copied (at most LV_PORT_CMD_TEXT_MAX - 1 characters)
+ * @return false if the queue was full
+ * @note A pending text of the same label is replaced
+ */
+bool lv_port_cmd_set_text(lv_obj_t * label, const char * text);
+
+/**
+ * @brief Toggle an LED widget (lv_led_toggle())
+ * @param led LED
+ * @return false if the queue was full
+ */
+bool lv_port_cmd_led_toggle(lv_obj_t * led);
+
+/**
+ * @brief Apply all queued commands
+ * @note Call from the LVGL task before lv_task_handler()
+ */
+void lv_port_cmd_process(void);
+
+/**
+ * @brief Sleep until woken or until the next LVGL timer is due (LVGL task)
+ * @param timeout_ms Return value of lv_timer_handler(), capped at LV_PORT_CMD_MAX_WAIT_MS
+ * @note The first call makes the calling task the one lv_port_cmd_wake() wakes up
+ */
+void lv_port_cmd_wait(uint32_t timeout_ms);
+
+/**
+ * @brief Wake the LVGL task from lv_port_cmd_wait()
+ * @note Callable from tasks and interrupts. Posting a command wakes it already
+ */
+void lv_port_cmd_wake(void);
+
+/**
+ * @brief Get command queue statistics
+ * @param out Output parameter: counters since the last reset
+ * @param reset Clear the counters after reading
+ */
+void lv_port_cmd_get_stats(lv_port_cmd_stats_t * out, bool reset);
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /*LV_PORT_CMD_H*/
@@ -10,8 +10,17 @@
  *      INCLUDES
  *********************/
 #include "lv_port_disp.h"
-#include "st7796.h"
+#include "lv_port_draw.h"
+#include "lv_port_font.h"
+#include "lv_port_img.h"
+#include "pico/stdlib.h"
+#if LV_PORT_DISP_PIPELINE
+#include "hardware/sync.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#endif
 #include <stdbool.h>
+#include <stdio.h>
 
 /*********************
  *      DEFINES
@@ -19,11 +28,53 @@
 #define MY_DISP_HOR_RES    320
 #define MY_DISP_VER_RES    480
 
+/* Pixels per strip buffer */
+#define DISP_BUF_SIZE      (MY_DISP_HOR_RES * LV_PORT_DISP_BUF_LINES)
+
+#if LV_PORT_DISP_PIPELINE
+/* Ring sizes, powers of two. Fill and image strips need no buffer, so more entries than buffers */
+#define TX_RING_SIZE       16
+#define FREE_RING_SIZE     8
+
+#if LV_PORT_DISP_BUF_COUNT > FREE_RING_SIZE
+#error "LV_PORT_DISP_BUF_COUNT is larger than FREE_RING_SIZE"
+#endif
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+/**
+ * @brief One strip queued for the panel
+ */
+typedef struct {
+    lv_area_t area;
+    const uint16_t * src;       // Pixels, NULL for a solid fill
+    uint16_t color;             // Fill color when src == NULL
+    lv_color_t * buf;           // Strip buffer to recycle after the transfer, NULL if none
+    bool splash;                // Take the splash timestamp when the transfer ends
+} tx_entry_t;
+#endif
+
 /**********************
  *  STATIC PROTOTYPES
  **********************/
 static void disp_init(void);
 static void disp_flush(lv_disp_drv_t * disp_drv, const lv_area_t * area, lv_color_t * color_p);
+#if !LV_PORT_DISP_PIPELINE
+static void disp_flush_done(void * user_data);
+#endif
+static void disp_splash_done(void);
+static void boot_splash_line(uint16_t y, uint16_t * line, void * user_data);
+#if LV_PORT_DISP_PIPELINE
+static void pipeline_init(void);
+static void pipeline_submit(lv_disp_drv_t * disp_drv, const tx_entry_t * entry);
+static void tx_task(void * param);
+static void tx_start_next(void);
+static void tx_done(void * user_data);
+#endif
+#if LV_PORT_DISP_PERF_LOG
+static void disp_monitor(lv_disp_drv_t * disp_drv, uint32_t time, uint32_t px);
+#endif
 
 /**********************
  *  STATIC VARIABLES
@@ -31,6 +82,49 @@ static void disp_flush(lv_disp_drv_t * disp_drv, const lv_area_t * area, lv_colo
 /* Display flush enable/disable flag */
 static volatile bool disp_flush_enabled = true;
 
+/* Window command statistics of the last complete frame */
+static st7796_stats_t frame_stats;
+
+/* Time spent decoding the boot splash (RLE565 and I8_565) */
+static uint32_t boot_decode_us = 0;
+
+/* Pixels sent without the draw buffer (current frame / last complete frame) */
+static uint32_t strip_fill_px, strip_img_px;
+static uint32_t frame_fill_px, frame_img_px;
+
+/* Time after boot when the first frame containing a direct image blit was on the panel */
+#if !LV_PORT_DISP_PIPELINE
+static volatile bool splash_armed = false;
+#endif
+static volatile uint32_t splash_us = 0;
+
+#if LV_PORT_DISP_PIPELINE
+/* Strip buffers, buf_pool[0] and buf_pool[1] start as LVGL's buf1/buf2 */
+static lv_color_t buf_pool[LV_PORT_DISP_BUF_COUNT][DISP_BUF_SIZE];
+
+/* Rendering core -> transmit core (single producer, single consumer) */
+static tx_entry_t tx_ring[TX_RING_SIZE];
+static volatile uint32_t tx_head = 0;       // Written by disp_flush() only, under tx_lock
+static volatile uint32_t tx_tail = 0;       // Written by the transmit side only
+
+/* Transmit core -> rendering core: buffers whose pixels have been sent */
+static lv_color_t * free_ring[FREE_RING_SIZE];
+static volatile uint32_t free_head = 0;     // Written by the transmit side only
+static volatile uint32_t free_tail = 0;     // Written by disp_flush() only
+
+/* Transmit side: tx_task and the DMA IRQ both run on core 0 and share this lock */
+static spin_lock_t * tx_lock;
+static volatile bool tx_running = false;
+static TaskHandle_t tx_handle = NULL;
+
+/* The other LVGL buffer was handed to the ring at the previous flush */
+static bool prev_handed = false;
+
+/* Time the transmitter was busy (SPI/PIO feeding the panel) */
+static volatile uint32_t tx_busy_us = 0;
+static uint32_t tx_busy_since = 0;
+#endif
+
 /**********************
  *   GLOBAL FUNCTIONS
  **********************/
@@ -45,6 +139,11 @@ void lv_port_disp_init(void)
      * -----------------------*/
     disp_init();
 
+    // Decode time of an RLE565 or I8_565 boot splash, kept out of the LVGL decode statistics
+    lv_port_img_stats_t img_stats;
+    lv_port_img_get_stats(&img_stats, true);
+    boot_decode_us = img_stats.decode_us;
+
     /*-----------------------------
      * Create LVGL draw buffer
      *----------------------------*/
@@ -68,17 +167,22 @@ void lv_port_disp_init(void)
      *    LVGL will always provide complete rendered screen in `flush_cb`, only need to change framebuffer address.
      */
 
-    /* Example 1: Single buffer configuration (saves memory) */
-    static lv_disp_draw_buf_t draw_buf_dsc_1;
-    static lv_color_t buf_1[MY_DISP_HOR_RES * 10];  // 10-row buffer
-    lv_disp_draw_buf_init(&draw_buf_dsc_1, buf_1, NULL, MY_DISP_HOR_RES * 10);
-
-    /* Example 2: Double buffer configuration (better performance, but requires more memory)
-    static lv_disp_draw_buf_t draw_buf_dsc_2;
-    static lv_color_t buf_2_1[MY_DISP_HOR_RES * 10];  // First buffer
-    static lv_color_t buf_2_2[MY_DISP_HOR_RES * 10];  // Second buffer
-    lv_disp_draw_buf_init(&draw_buf_dsc_2, buf_2_1, buf_2_2, MY_DISP_HOR_RES * 10);
-    */
+    static lv_disp_draw_buf_t draw_buf_dsc;
+#if LV_PORT_DISP_PIPELINE
+    /* Pipeline: LVGL always owns two buffers, the others are queued for the panel or free */
+    lv_disp_draw_buf_init(&draw_buf_dsc, buf_pool[0], buf_pool[1], DISP_BUF_SIZE);
+    pipeline_init();
+#else
+    static lv_color_t buf_1[DISP_BUF_SIZE];     // LV_PORT_DISP_BUF_LINES-row buffer
+#if LV_PORT_DISP_DOUBLE_BUF
+    /* Double buffer: LVGL renders into one strip while DMA sends the other */
+    static lv_color_t buf_2[DISP_BUF_SIZE];
+    lv_disp_draw_buf_init(&draw_buf_dsc, buf_1, buf_2, DISP_BUF_SIZE);
+#else
+    /* Single buffer: saves memory, rendering waits for each flush to finish */
+    lv_disp_draw_buf_init(&draw_buf_dsc, buf_1, NULL, DISP_BUF_SIZE);
+#endif
+#endif
 
     /*-----------------------------------
      * Register display driver in LVGL
@@ -94,18 +198,65 @@ void lv_port_disp_init(void)
     disp_drv.flush_cb = disp_flush;
 
     /* Set display buffer */
-    disp_drv.draw_buf = &draw_buf_dsc_1;
+    disp_drv.draw_buf = &draw_buf_dsc;
+
+#if LV_PORT_DISP_PERF_LOG
+    /* Called by LVGL after every refresh, used to measure frame rate */
+    disp_drv.monitor_cb = disp_monitor;
+#endif
 
     /* If using Example 3 full-screen double buffer, enable this option
     disp_drv.full_refresh = 1;
     */
 
-    /* GPU fill callback (if hardware acceleration available)
-    disp_drv.gpu_fill_cb = gpu_fill;
-    */
+    /* Software renderer with DMA-assisted fills (lv_port_draw.c) */
+    disp_drv.draw_ctx_init = lv_port_draw_ctx_init;
 
     /* Finally register the driver */
     lv_disp_drv_register(&disp_drv);
+
+    /* Decoder for RLE565 and I8_565 images (compressed splash) */
+    lv_port_img_init();
+}
+
+/**
+ * @brief Get window command statistics of the last complete frame
+ * @param out Output parameter: command bytes sent and saved by the window cache
+ */
+void lv_port_disp_get_frame_stats(st7796_stats_t * out)
+{
+    *out = frame_stats;
+}
+
+/**
+ * @brief Show an image on the panel as soon as it leaves sleep mode
+ * @param img Full screen image (display-native true color, RLE565 or I8_565)
+ * @note Call before lv_port_disp_init()
+ */
+void lv_port_disp_set_boot_splash(const lv_img_dsc_t * img)
+{
+    if (img->header.w != MY_DISP_HOR_RES || img->header.h != MY_DISP_VER_RES) {
+        return;
+    }
+
+    if (lv_port_img_is_encoded(img)) {
+        // Decoded row by row while the previous row is sent
+        st7796_set_boot_splash(NULL, boot_splash_line, (void *)img);
+    } else if (img->header.cf == LV_IMG_CF_TRUE_COLOR && !LV_COLOR_16_SWAP) {
+        // Same layout as a draw buffer: sent straight from flash
+        st7796_set_boot_splash((const uint16_t *)img->data, NULL, NULL);
+    }
+}
+
+/**
+ * @brief Get the time after boot at which the splash image was first on the panel
+ * @return Microseconds since boot, 0 if no image has been blitted directly yet
+ * @note The splash is the first frame that contained an unscaled opaque image blitted from flash
+ *       or decoded from an RLE565 or I8_565 image
+ */
+uint32_t lv_port_disp_get_splash_time_us(void)
+{
+    return splash_us;
 }
 
 /**
@@ -141,53 +292,355 @@ static void disp_init(void)
     st7796_init();
 }
 
+/**
+ * @brief Boot splash row callback: decode one row of an RLE565 or I8_565 image
+ * @param y Row
+ * @param line Output: MY_DISP_HOR_RES pixels
+ * @param user_data The lv_img_dsc_t
+ */
+static void boot_splash_line(uint16_t y, uint16_t * line, void * user_data)
+{
+    lv_port_img_decode((const lv_img_dsc_t *)user_data, 0, y, MY_DISP_HOR_RES, (lv_color_t *)line);
+}
+
 /**
  * @brief Flush internal buffer content to specified display area
  * @param disp_drv Display driver pointer
  * @param area Area to refresh
  * @param color_p Color data pointer (RGB565 format)
- * @note Can use DMA or hardware acceleration for this operation, but must call lv_disp_flush_ready() when complete
+ * @note Pixels are sent by DMA, lv_disp_flush_ready() is called from the DMA IRQ when the transfer ends.
+ *       With LV_PORT_DISP_PIPELINE the strip is only queued and LVGL continues with another buffer
  */
 static void disp_flush(lv_disp_drv_t * disp_drv, const lv_area_t * area, lv_color_t * color_p)
 {
+    bool last = lv_disp_flush_is_last(disp_drv);
+    uint32_t size = lv_area_get_width(area) * lv_area_get_height(area);
+
+    // Strip covered by a single opaque fill or image: its buffer was never written
+    lv_port_draw_strip_t strip;
+    bool direct = lv_port_draw_take_strip(color_p, area, &strip);
+
     // Check if refresh is allowed
     if (!disp_flush_enabled) {
+#if LV_PORT_DISP_PIPELINE
+        pipeline_submit(disp_drv, NULL);    // Still hand LVGL a buffer that is not queued
+#else
         lv_disp_flush_ready(disp_drv);
+#endif
         return;
     }
-    
-    // 1. Set display window (rectangular area to draw)
-    st7796_set_window(area->x1, area->y1, area->x2, area->y2);
-    
-    // 2. Calculate pixel count
-    uint32_t size = lv_area_get_width(area) * lv_area_get_height(area);
-    
-    // 3. Write color data
-    // LVGL's lv_color_t is configured as RGB565 (16-bit) in lv_conf.h
-    // This is compatible with ST7796's RGB565 format, can be transferred directly
-    st7796_write_color((uint16_t *)color_p, size);
-    
-    // 4. Notify LVGL that flush is complete
-    // Important: Must call this function to tell LVGL it can continue rendering next frame
+
+    // Latch per-frame statistics after the last strip, before its transfer can complete
+    if (direct) {
+        if (strip.src != NULL) {
+            strip_img_px += size;
+        } else {
+            strip_fill_px += size;
+        }
+    }
+    bool splash = false;
+    if (last) {
+        st7796_get_stats(&frame_stats, true);
+        frame_fill_px = strip_fill_px;
+        frame_img_px = strip_img_px;
+        strip_fill_px = 0;
+        strip_img_px = 0;
+
+        // Splash: first frame with an image blitted from flash or decoded by lv_port_img.c
+        lv_port_img_stats_t img_stats;
+        lv_port_img_get_stats(&img_stats, false);
+        splash = (splash_us == 0 && (frame_img_px > 0 || img_stats.decode_px > 0));
+    }
+
+#if LV_PORT_DISP_PIPELINE
+    // Queue the strip for core 0 and let LVGL continue with a free buffer
+    tx_entry_t entry = {
+        .area = *area,
+        .src = direct ? (const uint16_t *)strip.src : (const uint16_t *)color_p,   // NULL: fill
+        .color = direct ? strip.color.full : 0,
+        .buf = direct ? NULL : color_p,
+        .splash = splash,
+    };
+    pipeline_submit(disp_drv, &entry);
+#else
+    if (splash) {
+        // Previous strip must not take the timestamp, the window setup waits for it anyway
+        st7796_wait_idle();
+        splash_armed = true;
+    }
+
+    if (direct && strip.src == NULL) {
+        // 1. Stream the fill color from one DMA source word instead of the buffer
+        // st7796_fill_rect_async() sets the window itself
+        st7796_fill_rect_async(area->x1, area->y1, area->x2, area->y2, strip.color.full,
+                               disp_flush_done, disp_drv);
+    } else {
+        // 1. Set display window (rectangular area to draw)
+        st7796_set_window(area->x1, area->y1, area->x2, area->y2);
+
+        // 2. Pixel source: the draw buffer, or the image in flash for a direct blit
+        const uint16_t * src = direct ? (const uint16_t *)strip.src : (const uint16_t *)color_p;
+
+        // 3. Start writing color data
+        // LVGL's lv_color_t is configured as native RGB565 (16-bit, LV_COLOR_16_SWAP 0) in lv_conf.h
+        // The driver sends it as 16-bit SPI frames, so it can be transferred directly
+        // Returns immediately, LVGL keeps working while the strip goes out over SPI
+        st7796_write_color_async(src, size, disp_flush_done, disp_drv);
+    }
+#endif
+}
+
+#if !LV_PORT_DISP_PIPELINE
+/**
+ * @brief DMA transfer complete callback
+ * @param user_data Display driver pointer passed to st7796_write_color_async()
+ * @note Runs in DMA IRQ context
+ */
+static void disp_flush_done(void * user_data)
+{
+    if (splash_armed) {
+        splash_armed = false;
+        disp_splash_done();
+    }
+
+    // Important: Must call this function to tell LVGL the buffer can be reused
+    lv_disp_flush_ready((lv_disp_drv_t *)user_data);
+}
+#endif
+
+/**
+ * @brief Record the time at which the splash frame was completely on the panel
+ */
+static void disp_splash_done(void)
+{
+    splash_us = time_us_32();
+}
+
+#if LV_PORT_DISP_PIPELINE
+/**
+ * @brief Initialize the render/transmit pipeline
+ * @note buf_pool[0] and buf_pool[1] are given to LVGL, the rest start in the free ring
+ */
+static void pipeline_init(void)
+{
+    for (int i = 2; i < LV_PORT_DISP_BUF_COUNT; i++) {
+        free_ring[free_head % FREE_RING_SIZE] = buf_pool[i];
+        free_head++;
+    }
+
+    tx_lock = spin_lock_init(spin_lock_claim_unused(true));
+
+    // The DMA IRQ is enabled by st7796_init() on core 0, the task feeding it runs there too
+    xTaskCreate(tx_task, "disp_tx", 512, NULL, 4, &tx_handle);
+    vTaskCoreAffinitySet(tx_handle, (1 << 0));
+}
+
+/**
+ * @brief Queue a strip for the transmit core (rendering core)
+ * @param disp_drv Display driver pointer
+ * @param entry Strip to send, NULL to only recycle the buffers
+ * @note Calls lv_disp_flush_ready() before returning. If the other LVGL buffer is still
+ *       queued, it is replaced by a free one first, waiting for one if necessary
+ */
+static void pipeline_submit(lv_disp_drv_t * disp_drv, const tx_entry_t * entry)
+{
+    if (entry != NULL) {
+        // 1. Wait for ring space (only with many fill/image strips in a row)
+        while (tx_head - tx_tail >= TX_RING_SIZE) {
+            tight_loop_contents();
+        }
+
+        // 2. Queue it and check the transmitter in one go: tx_start_next() in the DMA IRQ
+        //    either sees the new entry or has already cleared tx_running, so it is never missed
+        uint32_t save = spin_lock_blocking(tx_lock);
+        tx_ring[tx_head % TX_RING_SIZE] = *entry;
+        tx_head++;
+        bool wake = !tx_running;
+        spin_unlock(tx_lock, save);
+
+        // Wake the transmit task if the transmitter went idle, otherwise the DMA IRQ picks it up
+        if (wake) {
+            xTaskNotifyGive(tx_handle);
+        }
+    }
+
+    // 3. LVGL swaps to the other buffer after this call; it must not still be queued
+    lv_disp_draw_buf_t * draw_buf = disp_drv->draw_buf;
+    if (prev_handed) {
+        while (free_tail == free_head) {
+            tight_loop_contents();
+        }
+        lv_color_t * buf = free_ring[free_tail % FREE_RING_SIZE];
+        free_tail++;
+
+        if (draw_buf->buf_act == draw_buf->buf1) {
+            draw_buf->buf2 = buf;
+        } else {
+            draw_buf->buf1 = buf;
+        }
+    }
+    prev_handed = (entry != NULL && entry->buf != NULL);
+
     lv_disp_flush_ready(disp_drv);
 }
 
-/*
- * Optional GPU acceleration callback function examples below
- * Can be implemented to improve performance if hardware supports it
+/**
+ * @brief Transmit task (core 0): starts the transmitter when strips arrive while it is idle
+ * @param param Unused
  */
+static void tx_task(void * param)
+{
+    (void)param;
 
-#if 0  // Change to 1 if GPU fill support is needed
+    for (;;) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+        uint32_t save = spin_lock_blocking(tx_lock);
+        if (!tx_running) {
+            tx_start_next();
+        }
+        spin_unlock(tx_lock, save);
+    }
+}
 
 /**
- * @brief GPU fill callback (optional)
- * @note Can implement this function to accelerate fill operations if GPU or DMA support available
+ * @brief Start sending the oldest queued strip
+ * @note Called with tx_lock held, on core 0. Clears tx_running when the ring is empty
  */
-static void gpu_fill(lv_disp_drv_t * disp_drv, lv_color_t * dest_buf, lv_coord_t dest_width,
-        const lv_area_t * fill_area, lv_color_t color)
+static void tx_start_next(void)
 {
-    /* Implement GPU fill logic */
-    /* Example: Use DMA to quickly fill with single color */
+    if (tx_tail == tx_head) {
+        if (tx_running) {
+            tx_busy_us += time_us_32() - tx_busy_since;
+        }
+        tx_running = false;
+        return;
+    }
+
+    if (!tx_running) {
+        tx_busy_since = time_us_32();
+    }
+    tx_running = true;
+
+    // The entry stays in the ring until tx_done(), so the producer cannot overwrite it
+    const tx_entry_t * e = &tx_ring[tx_tail % TX_RING_SIZE];
+    if (e->src == NULL) {
+        st7796_fill_rect_async(e->area.x1, e->area.y1, e->area.x2, e->area.y2, e->color,
+                               tx_done, NULL);
+    } else {
+        st7796_set_window(e->area.x1, e->area.y1, e->area.x2, e->area.y2);
+        st7796_write_color_async(e->src, lv_area_get_size(&e->area), tx_done, NULL);
+    }
 }
 
-#endif
\ No newline at end of file
+/**
+ * @brief Strip transfer complete callback
+ * @param user_data Unused
+ * @note Runs in DMA IRQ context on core 0, starts the next strip right away
+ */
+static void tx_done(void * user_data)
+{
+    (void)user_data;
+
+    uint32_t save = spin_lock_blocking(tx_lock);
+
+    const tx_entry_t * e = &tx_ring[tx_tail % TX_RING_SIZE];
+    if (e->buf != NULL) {
+        free_ring[free_head % FREE_RING_SIZE] = e->buf;
+        __dmb();
+        free_head++;
+    }
+    if (e->splash) {
+        disp_splash_done();
+    }
+    __dmb();
+    tx_tail++;
+
+    tx_start_next();
+
+    spin_unlock(tx_lock, save);
+}
+#endif
+
+#if LV_PORT_DISP_PERF_LOG
+/**
+ * @brief Refresh monitor callback, prints statistics once per second
+ * @param disp_drv Display driver pointer
+ * @param time Time spent on this refresh (ms)
+ * @param px Number of pixels refreshed
+ */
+static void disp_monitor(lv_disp_drv_t * disp_drv, uint32_t time, uint32_t px)
+{
+    static uint32_t frames = 0;
+    static uint32_t busy_ms = 0;
+    static uint32_t pixels = 0;
+    static uint32_t start = 0;
+
+    static bool splash_reported = false;
+
+    (void)disp_drv;
+
+    if (!splash_reported && splash_us != 0) {
+        if (st7796_get_boot_splash_us() != 0) {
+            printf("disp: boot splash on panel %lu us after boot (%lu us decoding)\n",
+                   (unsigned long)st7796_get_boot_splash_us(),
+                   (unsigned long)boot_decode_us);
+        }
+        printf("disp: splash on panel %lu us after boot\n", (unsigned long)splash_us);
+        splash_reported = true;
+    }
+
+    frames++;
+    busy_ms += time;
+    pixels += px;
+
+    uint32_t elapsed = lv_tick_elaps(start);
+    if (elapsed >= 1000) {
+        lv_port_draw_stats_t draw_stats;
+        lv_port_draw_get_stats(&draw_stats, true);
+        lv_port_img_stats_t img_stats;
+        lv_port_img_get_stats(&img_stats, true);
+        lv_port_font_stats_t font_stats;
+        lv_port_font_get_stats(&font_stats, true);
+
+        printf("disp: %lu fps, %lu ms/frame, %lu px/frame, cmd %lu B sent %lu B saved, "
+               "direct %lu px fill %lu px img (last frame), %s buffer x %d lines\n",
+               (unsigned long)(frames * 1000 / elapsed),
+               (unsigned long)(busy_ms / frames),
+               (unsigned long)(pixels / frames),
+               (unsigned long)frame_stats.cmd_bytes_sent,
+               (unsigned long)frame_stats.cmd_bytes_saved,
+               (unsigned long)frame_fill_px,
+               (unsigned long)frame_img_px,
+               LV_PORT_DISP_DOUBLE_BUF ? "double" : "single",
+               LV_PORT_DISP_BUF_LINES);
+#if LV_PORT_DISP_PIPELINE
+        // Approximate: a transfer running right now is counted when the transmitter goes idle
+        uint32_t busy_us = tx_busy_us;
+        tx_busy_us = 0;
+        printf("pipe: transmitter %lu%% busy, %d buffers\n",
+               (unsigned long)((uint64_t)busy_us * 100 / ((uint64_t)elapsed * 1000)),
+               LV_PORT_DISP_BUF_COUNT);
+#endif
+        printf("draw: %lu split blends, %lu px core 0, %lu px core 1 (last second)\n",
+               (unsigned long)draw_stats.split_blends,
+               (unsigned long)draw_stats.px_core0,
+               (unsigned long)draw_stats.px_core1);
+        if (img_stats.decode_px > 0) {
+            printf("img: %lu px decoded in %lu us (last second)\n",
+                   (unsigned long)img_stats.decode_px,
+                   (unsigned long)img_stats.decode_us);
+        }
+        if (font_stats.hits + font_stats.misses + font_stats.uncached > 0) {
+            printf("font: %lu glyph hits, %lu misses, %lu uncached (last second)\n",
+                   (unsigned long)font_stats.hits,
+                   (unsigned long)font_stats.misses,
+                   (unsigned long)font_stats.uncached);
+        }
+        frames = 0;
+        busy_ms = 0;
+        pixels = 0;
+        start = lv_tick_get();
+    }
+}
+#endif
@@ -21,6 +21,42 @@ extern "C" {
 #else
 #include "lvgl/lvgl.h"
 #endif
+#include "st7796.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+/* Draw buffer configuration (can be overridden at build time, see CMakeLists.txt) */
+#ifndef LV_PORT_DISP_BUF_LINES
+#define LV_PORT_DISP_BUF_LINES      10      // Rows per strip buffer
+#endif
+
+#ifndef LV_PORT_DISP_DOUBLE_BUF
+#define LV_PORT_DISP_DOUBLE_BUF     1       // 1: two strip buffers, 0: single strip buffer
+#endif
+
+/* Print refresh statistics (frames per second) over stdio */
+#ifndef LV_PORT_DISP_PERF_LOG
+#define LV_PORT_DISP_PERF_LOG       0
+#endif
+
+/* Render/transmit pipeline: flush_cb only queues strips, a task on core 0 feeds the panel */
+#ifndef LV_PORT_DISP_PIPELINE
+#define LV_PORT_DISP_PIPELINE       0
+#endif
+
+/* Strip buffers in the pipeline (2 are owned by LVGL, the rest can be in flight) */
+#ifndef LV_PORT_DISP_BUF_COUNT
+#define LV_PORT_DISP_BUF_COUNT      4
+#endif
+
+#if LV_PORT_DISP_PIPELINE && !LV_PORT_DISP_DOUBLE_BUF
+#error "LV_PORT_DISP_PIPELINE requires LV_PORT_DISP_DOUBLE_BUF"
+#endif
+
+#if LV_PORT_DISP_PIPELINE && LV_PORT_DISP_BUF_COUNT < 2
+#error "LV_PORT_DISP_BUF_COUNT must be at least 2"
+#endif
 
 /**********************
  *      TYPEDEFS
@@ -35,6 +71,26 @@ extern "C" {
  */
 void lv_port_disp_init(void);
 
+/**
+ * @brief Show an image on the panel as soon as it leaves sleep mode, before LVGL draws anything
+ * @param img Full screen image (display-native true color, RLE565 or I8_565, normally in flash)
+ * @note Call before lv_port_disp_init(). Show the same image on the first LVGL screen and
+ *       LVGL takes over without a visible change. Other sizes and formats are ignored
+ */
+void lv_port_disp_set_boot_splash(const lv_img_dsc_t * img);
+
+/**
+ * @brief Get window command statistics of the last complete frame
+ * @param out Output parameter: command bytes sent and saved by the window cache
+ */
+void lv_port_disp_get_frame_stats(st7796_stats_t * out);
+
+/**
+ * @brief Get the time after boot at which the splash image was first on the panel
+ * @return Microseconds since boot, 0 if no image has been blitted directly yet
+ */
+uint32_t lv_port_disp_get_splash_time_us(void);
+
 /**
  * @brief Enable screen refresh
  */
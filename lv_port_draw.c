@@ -0,0 +1,506 @@
+/**
+ * @file lv_port_draw.c
+ * @brief LVGL Draw Context Porting Layer
+ * @note Software renderer with the blend stage assisted by RP2040 DMA
+ * @author NIGHT
+ * @date 2025-10-27
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "lv_port_draw.h"
+#include "lv_port_img.h"
+#include "src/draw/sw/lv_draw_sw.h"
+#include "hardware/dma.h"
+#include "hardware/regs/addressmap.h"
+#if LV_PORT_DRAW_DUAL_CORE
+#include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
+#endif
+
+/*********************
+ *      DEFINES
+ *********************/
+#if LV_COLOR_DEPTH != 16
+#error "lv_port_draw.c expects LV_COLOR_DEPTH 16 (RGB565)"
+#endif
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+/**
+ * @brief Strip whose only content so far is one opaque fill or unscaled opaque image
+ * @note While pending, the draw buffer has not been written at all
+ */
+typedef struct {
+    bool pending;
+    lv_color_t * buf;           // Strip buffer the content belongs to
+    lv_area_t area;             // Strip area (draw_ctx->buf_area)
+    lv_port_draw_strip_t content;
+} bypass_strip_t;
+
+#if LV_PORT_DRAW_DUAL_CORE
+/**
+ * @brief Half of a blend handed to the helper task
+ */
+typedef struct {
+    lv_draw_sw_ctx_t ctx;       // Copy of the caller's context with clip_area = &clip
+    lv_area_t clip;
+    const lv_draw_sw_blend_dsc_t * dsc;
+} split_job_t;
+#endif
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void port_blend(lv_draw_ctx_t * draw_ctx, const lv_draw_sw_blend_dsc_t * dsc);
+static lv_res_t port_draw_img(lv_draw_ctx_t * draw_ctx, const lv_draw_img_dsc_t * dsc,
+                              const lv_area_t * coords, const void * src);
+static void port_buffer_copy(lv_draw_ctx_t * draw_ctx,
+                             void * dest_buf, lv_coord_t dest_stride, const lv_area_t * dest_area,
+                             void * src_buf, lv_coord_t src_stride, const lv_area_t * src_area);
+static bool is_strip_buf(const void * buf);
+static bool strip_is_covered(lv_draw_ctx_t * draw_ctx, const lv_area_t * blend_area);
+static void bypass_record(lv_draw_ctx_t * draw_ctx, const lv_color_t * src, lv_color_t color);
+static void bypass_materialize(void);
+static void dma_fill_area(lv_color_t * buf, const lv_area_t * buf_area, const lv_area_t * area,
+                          lv_color_t color);
+static void dma_fill16(uint16_t * dest, uint16_t color, uint32_t count);
+#if LV_PORT_DRAW_DUAL_CORE
+static void split_init(void);
+static bool blend_split(lv_draw_ctx_t * draw_ctx, const lv_draw_sw_blend_dsc_t * dsc,
+                        const lv_area_t * blend_area);
+static void split_task(void * param);
+#endif
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+/* Memory fill DMA channel: fixed read address, incrementing write address */
+static int fill_chan = -1;
+static dma_channel_config fill_cfg;
+static uint32_t fill_word;
+
+static bypass_strip_t bypass = { .pending = false };
+
+static lv_port_draw_stats_t stats;
+
+#if LV_PORT_DRAW_DUAL_CORE
+static TaskHandle_t split_handle = NULL;
+static SemaphoreHandle_t split_start = NULL;
+static SemaphoreHandle_t split_done = NULL;
+static split_job_t split_job;
+#endif
+
+/* Software implementation wrapped by port_buffer_copy() */
+static void (*sw_buffer_copy)(lv_draw_ctx_t * draw_ctx,
+                              void * dest_buf, lv_coord_t dest_stride, const lv_area_t * dest_area,
+                              void * src_buf, lv_coord_t src_stride, const lv_area_t * src_area);
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+/**
+ * @brief Initialize the draw context
+ * @param disp_drv Display driver pointer
+ * @param draw_ctx Draw context to initialize (sizeof(lv_draw_sw_ctx_t))
+ */
+void lv_port_draw_ctx_init(lv_disp_drv_t * disp_drv, lv_draw_ctx_t * draw_ctx)
+{
+    // Start from the software renderer and replace only the blend stage
+    lv_draw_sw_init_ctx(disp_drv, draw_ctx);
+
+    lv_draw_sw_ctx_t * sw_ctx = (lv_draw_sw_ctx_t *)draw_ctx;
+    sw_ctx->blend = port_blend;
+
+    sw_buffer_copy = draw_ctx->buffer_copy;
+    draw_ctx->buffer_copy = port_buffer_copy;
+
+    // RLE565 and I8_565 images are decoded straight into the strip buffer
+    draw_ctx->draw_img = port_draw_img;
+
+    if (fill_chan < 0) {
+        fill_chan = dma_claim_unused_channel(true);
+        fill_cfg = dma_channel_get_default_config(fill_chan);
+        channel_config_set_transfer_data_size(&fill_cfg, DMA_SIZE_32);
+        channel_config_set_read_increment(&fill_cfg, false);
+        channel_config_set_write_increment(&fill_cfg, true);
+    }
+
+#if LV_PORT_DRAW_DUAL_CORE
+    split_init();
+#endif
+}
+
+/**
+ * @brief Check whether a strip is covered by a single opaque fill or unscaled opaque image
+ * @param buf Draw buffer passed to flush_cb
+ * @param area Area passed to flush_cb
+ * @param strip Output parameter: what to send instead of the buffer
+ * @return true if the strip can be sent to the panel directly
+ */
+bool lv_port_draw_take_strip(const lv_color_t * buf, const lv_area_t * area, lv_port_draw_strip_t * strip)
+{
+    if (!bypass.pending || bypass.buf != buf) {
+        return false;
+    }
+
+    if (!_lv_area_is_equal(&bypass.area, area)) {
+        // Should not happen, but never flush a buffer that was skipped
+        bypass_materialize();
+        return false;
+    }
+
+    *strip = bypass.content;
+    bypass.pending = false;
+    return true;
+}
+
+/**
+ * @brief Get software blend statistics
+ * @param out Output parameter: statistics since the last reset
+ * @param reset true to clear the counters after reading
+ */
+void lv_port_draw_get_stats(lv_port_draw_stats_t * out, bool reset)
+{
+    *out = stats;
+    if (reset) {
+        lv_memset_00(&stats, sizeof(stats));
+    }
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+/**
+ * @brief Blend callback of the draw context
+ * @param draw_ctx Draw context
+ * @param dsc Blend descriptor (fill when src_buf == NULL)
+ * @note Opaque fills and unscaled opaque images covering the whole strip are only recorded,
+ *       other large opaque fills are done by DMA, the rest goes to the software blender
+ */
+static void port_blend(lv_draw_ctx_t * draw_ctx, const lv_draw_sw_blend_dsc_t * dsc)
+{
+    lv_area_t blend_area;
+    if (!_lv_area_intersect(&blend_area, dsc->blend_area, draw_ctx->clip_area)) {
+        return;
+    }
+
+    bool opaque = (dsc->mask_buf == NULL || dsc->mask_res == LV_DRAW_MASK_RES_FULL_COVER) &&
+                  dsc->opa >= LV_OPA_MAX &&
+                  dsc->blend_mode == LV_BLEND_MODE_NORMAL;
+    bool opaque_fill = opaque && dsc->src_buf == NULL;
+
+    // 1. Fill covers the whole strip (screen backgrounds after lv_obj_clean(), large
+    //    button faces): skip the buffer, disp_flush() streams the color to the panel
+    if (opaque_fill && strip_is_covered(draw_ctx, &blend_area)) {
+        bypass_record(draw_ctx, NULL, dsc->color);
+        return;
+    }
+
+    // 2. Unscaled opaque true color image covers the whole strip (the sea splash):
+    //    LVGL passes the decoded image itself as src_buf, which for an image in
+    //    flash is the XIP address, so disp_flush() can DMA it straight to the panel.
+    //    Only when the image rows are contiguous for this strip (same width), and not
+    //    for rows a decoder wrote to RAM: that buffer is freed before the flush.
+    if (opaque && dsc->src_buf != NULL && (uintptr_t)dsc->src_buf < SRAM_BASE &&
+        strip_is_covered(draw_ctx, &blend_area)) {
+        lv_coord_t src_stride = lv_area_get_width(dsc->blend_area);
+        if (src_stride == lv_area_get_width(draw_ctx->buf_area)) {
+            const lv_color_t * src = dsc->src_buf +
+                                     (draw_ctx->buf_area->y1 - dsc->blend_area->y1) * src_stride +
+                                     (draw_ctx->buf_area->x1 - dsc->blend_area->x1);
+            bypass_record(draw_ctx, src, dsc->color);
+            return;
+        }
+    }
+
+    // 3. Something is drawn on top of a skipped strip: write it into the buffer first
+    if (bypass.pending && bypass.buf == draw_ctx->buf) {
+        bypass_materialize();
+    }
+
+    // 4. Other large opaque fills: DMA instead of the CPU loop
+    if (opaque_fill && lv_area_get_size(&blend_area) >= LV_PORT_DRAW_DMA_FILL_MIN) {
+        dma_fill_area(draw_ctx->buf, draw_ctx->buf_area, &blend_area, dsc->color);
+        return;
+    }
+
+#if LV_PORT_DRAW_DUAL_CORE
+    // 5. Large software blends (images with alpha or opacity, masked areas): both cores
+    if (blend_split(draw_ctx, dsc, &blend_area)) {
+        return;
+    }
+#endif
+
+    stats.px_core1 += lv_area_get_size(&blend_area);
+    lv_draw_sw_blend_basic(draw_ctx, dsc);
+}
+
+/**
+ * @brief Image draw callback of the draw context
+ * @param draw_ctx Draw context
+ * @param dsc Image draw descriptor
+ * @param coords Image area on the screen
+ * @param src Image source
+ * @return LV_RES_OK if drawn, LV_RES_INV to let LVGL decode and draw it
+ * @note Unscaled opaque RLE565 and I8_565 images are decoded row by row into the strip buffer.
+ *       Through LVGL they would be decoded into a temporary buffer and blended from there
+ */
+static lv_res_t port_draw_img(lv_draw_ctx_t * draw_ctx, const lv_draw_img_dsc_t * dsc,
+                              const lv_area_t * coords, const void * src)
+{
+    if (!lv_port_img_is_encoded(src) ||
+        dsc->angle != 0 || dsc->zoom != LV_IMG_ZOOM_NONE ||
+        dsc->opa < LV_OPA_MAX || dsc->recolor_opa > LV_OPA_MIN ||
+        dsc->blend_mode != LV_BLEND_MODE_NORMAL) {
+        return LV_RES_INV;
+    }
+
+    const lv_img_dsc_t * img = src;
+    if (lv_area_get_width(coords) != (lv_coord_t)img->header.w ||
+        lv_area_get_height(coords) != (lv_coord_t)img->header.h) {
+        return LV_RES_INV;
+    }
+
+    lv_area_t area;
+    if (!_lv_area_intersect(&area, coords, draw_ctx->clip_area)) {
+        return LV_RES_OK;
+    }
+
+    if (!is_strip_buf(draw_ctx->buf) || lv_draw_mask_is_any(&area)) {
+        return LV_RES_INV;
+    }
+
+    // Earlier content of this strip: dropped if the image hides it, written out otherwise
+    if (bypass.pending && bypass.buf == draw_ctx->buf) {
+        if (_lv_area_is_in(draw_ctx->buf_area, &area, 0)) {
+            bypass.pending = false;
+        } else {
+            bypass_materialize();
+        }
+    }
+
+    lv_coord_t stride = lv_area_get_width(draw_ctx->buf_area);
+    lv_coord_t w = lv_area_get_width(&area);
+    lv_color_t * dest = (lv_color_t *)draw_ctx->buf +
+                        (area.y1 - draw_ctx->buf_area->y1) * stride +
+                        (area.x1 - draw_ctx->buf_area->x1);
+
+    for (lv_coord_t y = area.y1; y <= area.y2; y++) {
+        lv_port_img_decode(img, area.x1 - coords->x1, y - coords->y1, w, dest);
+        dest += stride;
+    }
+
+    return LV_RES_OK;
+}
+
+/**
+ * @brief Buffer copy callback of the draw context
+ * @note Materializes a skipped strip before its buffer is read or written
+ */
+static void port_buffer_copy(lv_draw_ctx_t * draw_ctx,
+                             void * dest_buf, lv_coord_t dest_stride, const lv_area_t * dest_area,
+                             void * src_buf, lv_coord_t src_stride, const lv_area_t * src_area)
+{
+    if (bypass.pending && (bypass.buf == dest_buf || bypass.buf == src_buf)) {
+        bypass_materialize();
+    }
+
+    sw_buffer_copy(draw_ctx, dest_buf, dest_stride, dest_area, src_buf, src_stride, src_area);
+}
+
+/**
+ * @brief Check whether a buffer is one of the display strip buffers
+ * @param buf Buffer pointer
+ * @return true for strip buffers, false for layers or when the strip is post-processed
+ */
+static bool is_strip_buf(const void * buf)
+{
+    lv_disp_t * disp = _lv_refr_get_disp_refreshing();
+    if (disp == NULL) {
+        return false;
+    }
+
+    lv_disp_drv_t * drv = disp->driver;
+    if (drv->full_refresh || drv->direct_mode || drv->rotated != LV_DISP_ROT_NONE) {
+        return false;   // Buffer content is used beyond flush_cb
+    }
+
+    return buf == drv->draw_buf->buf1 || buf == drv->draw_buf->buf2;
+}
+
+/**
+ * @brief Check whether a blend covers the whole display strip buffer
+ * @param draw_ctx Draw context
+ * @param blend_area Blend area clipped to draw_ctx->clip_area
+ * @return true if the strip buffer would be completely overwritten
+ */
+static bool strip_is_covered(lv_draw_ctx_t * draw_ctx, const lv_area_t * blend_area)
+{
+    return _lv_area_is_in(draw_ctx->buf_area, blend_area, 0) && is_strip_buf(draw_ctx->buf);
+}
+
+/**
+ * @brief Record the content of a strip instead of rendering it
+ * @param draw_ctx Draw context
+ * @param src Contiguous image pixels of the strip, NULL for a fill
+ * @param color Fill color (unused for images)
+ * @note Replaces an earlier pending content, it is completely covered
+ */
+static void bypass_record(lv_draw_ctx_t * draw_ctx, const lv_color_t * src, lv_color_t color)
+{
+    bypass.pending = true;
+    bypass.buf = draw_ctx->buf;
+    bypass.area = *draw_ctx->buf_area;
+    bypass.content.src = src;
+    bypass.content.color = color;
+}
+
+/**
+ * @brief Write a skipped strip into its buffer
+ */
+static void bypass_materialize(void)
+{
+    uint32_t size = lv_area_get_size(&bypass.area);
+
+    if (bypass.content.src != NULL) {
+        lv_memcpy(bypass.buf, bypass.content.src, size * sizeof(lv_color_t));
+    } else {
+        dma_fill16((uint16_t *)bypass.buf, bypass.content.color.full, size);
+    }
+    bypass.pending = false;
+}
+
+/**
+ * @brief Fill an area of a draw buffer by DMA
+ * @param buf Draw buffer
+ * @param buf_area Area of the draw buffer on the screen
+ * @param area Area to fill (inside buf_area)
+ * @param color Fill color
+ */
+static void dma_fill_area(lv_color_t * buf, const lv_area_t * buf_area, const lv_area_t * area,
+                          lv_color_t color)
+{
+    lv_coord_t stride = lv_area_get_width(buf_area);
+    lv_coord_t w = lv_area_get_width(area);
+    lv_coord_t h = lv_area_get_height(area);
+
+    lv_color_t * dest = buf + (area->y1 - buf_area->y1) * stride + (area->x1 - buf_area->x1);
+
+    if (w == stride) {
+        // Full-width rows are contiguous, one transfer
+        dma_fill16((uint16_t *)dest, color.full, (uint32_t)w * h);
+        return;
+    }
+
+    for (lv_coord_t y = 0; y < h; y++) {
+        dma_fill16((uint16_t *)dest, color.full, w);
+        dest += stride;
+    }
+}
+
+/**
+ * @brief Fill memory with a 16-bit value using 32-bit DMA writes
+ * @param dest Destination (halfword aligned)
+ * @param color Value to store
+ * @param count Number of halfwords
+ */
+static void dma_fill16(uint16_t * dest, uint16_t color, uint32_t count)
+{
+    // Align to a word boundary for 32-bit writes
+    if (((uintptr_t)dest & 2) && count > 0) {
+        *dest++ = color;
+        count--;
+    }
+
+    if (count >= 2) {
+        fill_word = ((uint32_t)color << 16) | color;
+        dma_channel_configure(fill_chan, &fill_cfg, dest, &fill_word, count / 2, true);
+        dma_channel_wait_for_finish_blocking(fill_chan);
+    }
+
+    if (count & 1) {
+        dest[count - 1] = color;
+    }
+}
+
+#if LV_PORT_DRAW_DUAL_CORE
+/**
+ * @brief Create the helper task that blends on core 0
+ */
+static void split_init(void)
+{
+    if (split_handle != NULL) {
+        return;
+    }
+
+    split_start = xSemaphoreCreateBinary();
+    split_done = xSemaphoreCreateBinary();
+
+    // Above task0 so the rendering core never waits behind application work
+    xTaskCreate(split_task, "draw0", 512, NULL, 3, &split_handle);
+    vTaskCoreAffinitySet(split_handle, (1 << 0));
+}
+
+/**
+ * @brief Blend one half of an area on core 0 and the other half on the calling core
+ * @param draw_ctx Draw context
+ * @param dsc Blend descriptor
+ * @param blend_area Blend area clipped to draw_ctx->clip_area
+ * @return false if the blend was not split and still has to be done by the caller
+ * @note lv_draw_sw_blend_basic() only touches the buffer inside clip_area, so each
+ *       half gets a copy of the context with its own clip area and the same descriptor
+ */
+static bool blend_split(lv_draw_ctx_t * draw_ctx, const lv_draw_sw_blend_dsc_t * dsc,
+                        const lv_area_t * blend_area)
+{
+    lv_coord_t h = lv_area_get_height(blend_area);
+    if (split_handle == NULL || h < 2 ||
+        lv_area_get_size(blend_area) < LV_PORT_DRAW_SPLIT_MIN ||
+        xTaskGetSchedulerState() != taskSCHEDULER_RUNNING) {
+        return false;
+    }
+
+    // Top half on core 0
+    split_job.ctx = *(lv_draw_sw_ctx_t *)draw_ctx;
+    split_job.clip = *blend_area;
+    split_job.clip.y2 = blend_area->y1 + h / 2 - 1;
+    split_job.ctx.base_draw.clip_area = &split_job.clip;
+    split_job.dsc = dsc;
+    xSemaphoreGive(split_start);
+
+    // Bottom half here
+    lv_draw_sw_ctx_t own = *(lv_draw_sw_ctx_t *)draw_ctx;
+    lv_area_t own_clip = *blend_area;
+    own_clip.y1 = split_job.clip.y2 + 1;
+    own.base_draw.clip_area = &own_clip;
+    lv_draw_sw_blend_basic(&own.base_draw, dsc);
+
+    xSemaphoreTake(split_done, portMAX_DELAY);
+
+    stats.split_blends++;
+    stats.px_core0 += lv_area_get_size(&split_job.clip);
+    stats.px_core1 += lv_area_get_size(&own_clip);
+    return true;
+}
+
+/**
+ * @brief Helper task on core 0: blends the half handed over by blend_split()
+ * @param param Unused
+ */
+static void split_task(void * param)
+{
+    (void)param;
+
+    for (;;) {
+        xSemaphoreTake(split_start, portMAX_DELAY);
+        lv_draw_sw_blend_basic(&split_job.ctx.base_draw, split_job.dsc);
+        xSemaphoreGive(split_done);
+    }
+}
+#endif
@@ -0,0 +1,95 @@
+/**
+ * @file lv_port_draw.h
+ * @brief LVGL Draw Context Porting Layer (hardware-assisted software rendering)
+ * @author NIGHT
+ * @date 2025-10-27
+ */
+
+#ifndef LV_PORT_DRAW_H
+#define LV_PORT_DRAW_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#if defined(LV_LVGL_H_INCLUDE_SIMPLE)
+#include "lvgl.h"
+#else
+#include "lvgl/lvgl.h"
+#endif
+#include <stdbool.h>
+
+/*********************
+ *      DEFINES
+ *********************/
+/* Opaque fills of at least this many pixels are done by DMA instead of the CPU */
+#ifndef LV_PORT_DRAW_DMA_FILL_MIN
+#define LV_PORT_DRAW_DMA_FILL_MIN   256
+#endif
+
+/* Split software blends between both cores (helper task pinned to core 0) */
+#ifndef LV_PORT_DRAW_DUAL_CORE
+#define LV_PORT_DRAW_DUAL_CORE      0
+#endif
+
+/* Software blends of at least this many pixels are split, smaller ones are not worth the handoff */
+#ifndef LV_PORT_DRAW_SPLIT_MIN
+#define LV_PORT_DRAW_SPLIT_MIN      2048
+#endif
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+/**
+ * @brief Content of a strip that was not rendered into its draw buffer
+ */
+typedef struct {
+    const lv_color_t * src;     // Contiguous image pixels (flash), NULL for a solid fill
+    lv_color_t color;           // Fill color when src == NULL
+} lv_port_draw_strip_t;
+
+/**
+ * @brief Software blend statistics
+ */
+typedef struct {
+    uint32_t split_blends;      // Blends split between both cores
+    uint32_t px_core0;          // Pixels blended by the helper task on core 0
+    uint32_t px_core1;          // Pixels blended by the rendering task
+} lv_port_draw_stats_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+/**
+ * @brief Initialize the draw context (set as disp_drv.draw_ctx_init)
+ * @param disp_drv Display driver pointer
+ * @param draw_ctx Draw context to initialize
+ * @note Software renderer with a DMA-assisted blend stage
+ */
+void lv_port_draw_ctx_init(lv_disp_drv_t * disp_drv, lv_draw_ctx_t * draw_ctx);
+
+/**
+ * @brief Check whether a strip is covered by a single opaque fill or unscaled opaque image
+ * @param buf Draw buffer passed to flush_cb
+ * @param area Area passed to flush_cb
+ * @param strip Output parameter: what to send instead of the buffer
+ * @return true if the buffer was never written and the strip can be sent to the panel directly
+ * @note Clears the pending state, call once per flush
+ */
+bool lv_port_draw_take_strip(const lv_color_t * buf, const lv_area_t * area, lv_port_draw_strip_t * strip);
+
+/**
+ * @brief Get software blend statistics
+ * @param out Output parameter: statistics since the last reset
+ * @param reset true to clear the counters after reading
+ */
+void lv_port_draw_get_stats(lv_port_draw_stats_t * out, bool reset);
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /*LV_PORT_DRAW_H*/
@@ -0,0 +1,167 @@
+/**
+ * @file lv_port_font.c
+ * @brief LVGL Font Porting Layer: RAM cache of expanded glyph bitmaps
+ * @note Font bitmaps are packed at 1-4 bpp (or compressed), so every redraw of a label shifts
+ *       and masks each pixel again. Cached glyphs are kept at one opacity byte per pixel and
+ *       LVGL draws them with its 8 bpp path, the same opacity as the 4 bpp table
+ * @author NIGHT
+ * @date 2025-10-27
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "lv_port_font.h"
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct {
+    const lv_font_t * font;
+    uint32_t letter;
+    uint32_t used;              // Last use (cache clock), 0 = free
+    uint8_t bitmap[LV_PORT_FONT_CACHE_SLOT];
+} glyph_entry_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static bool is_cached(const lv_font_glyph_dsc_t * dsc);
+static void expand(const uint8_t * src, uint8_t bpp, uint32_t px, uint8_t * dst);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+#if LV_PORT_FONT_CACHE_SIZE > 0
+static glyph_entry_t cache[LV_PORT_FONT_CACHE_SIZE];
+#endif
+static uint32_t cache_clock;
+static lv_port_font_stats_t stats;
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+/**
+ * @brief Glyph descriptor callback of the generated fonts (lv_font_t.get_glyph_dsc)
+ * @param font Font
+ * @param dsc_out Output parameter: glyph descriptor
+ * @param letter Unicode code point
+ * @param letter_next Following code point (kerning)
+ * @return true if the font has the glyph
+ */
+bool lv_port_font_get_glyph_dsc(const lv_font_t * font, lv_font_glyph_dsc_t * dsc_out,
+                                uint32_t letter, uint32_t letter_next)
+{
+    if (!lv_font_get_glyph_dsc_fmt_txt(font, dsc_out, letter, letter_next)) {
+        return false;
+    }
+
+    // Must match lv_port_font_get_glyph_bitmap(), LVGL reads the bitmap with this bpp
+    if (is_cached(dsc_out)) {
+        dsc_out->bpp = 8;
+    }
+    return true;
+}
+
+/**
+ * @brief Glyph bitmap callback of the generated fonts (lv_font_t.get_glyph_bitmap)
+ * @param font Font
+ * @param letter Unicode code point
+ * @return Bitmap in the bpp reported by lv_port_font_get_glyph_dsc(), NULL if there is none
+ */
+const uint8_t * lv_port_font_get_glyph_bitmap(const lv_font_t * font, uint32_t letter)
+{
+#if LV_PORT_FONT_CACHE_SIZE > 0
+    // 1. Hit: least recently used entry found on the way as the victim for a miss
+    glyph_entry_t * victim = &cache[0];
+    for (int i = 0; i < LV_PORT_FONT_CACHE_SIZE; i++) {
+        glyph_entry_t * e = &cache[i];
+        if (e->used != 0 && e->font == font && e->letter == letter) {
+            e->used = ++cache_clock;
+            stats.hits++;
+            return e->bitmap;
+        }
+        if (e->used < victim->used) {
+            victim = e;
+        }
+    }
+
+    // 2. Miss: glyphs that do not fit a slot are read from the font as they are
+    lv_font_glyph_dsc_t dsc;
+    if (!lv_font_get_glyph_dsc_fmt_txt(font, &dsc, letter, 0) || !is_cached(&dsc)) {
+        stats.uncached++;
+        return lv_font_get_bitmap_fmt_txt(font, letter);
+    }
+
+    // Decompresses into LVGL's buffer for compressed fonts, copied out before the next glyph
+    const uint8_t * src = lv_font_get_bitmap_fmt_txt(font, letter);
+    if (src == NULL) {
+        return NULL;
+    }
+
+    expand(src, dsc.bpp, (uint32_t)dsc.box_w * dsc.box_h, victim->bitmap);
+    victim->font = font;
+    victim->letter = letter;
+    victim->used = ++cache_clock;
+    stats.misses++;
+    return victim->bitmap;
+#else
+    stats.uncached++;
+    return lv_font_get_bitmap_fmt_txt(font, letter);
+#endif
+}
+
+/**
+ * @brief Get glyph cache statistics
+ * @param out Output parameter: counters since the last reset
+ * @param reset Clear the counters after reading
+ */
+void lv_port_font_get_stats(lv_port_font_stats_t * out, bool reset)
+{
+    *out = stats;
+    if (reset) {
+        stats.hits = 0;
+        stats.misses = 0;
+        stats.uncached = 0;
+    }
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+/**
+ * @brief Check whether a glyph is served from the cache
+ * @param dsc Glyph descriptor as returned by the font
+ * @return true for a packed (1-4 bpp) glyph with a bitmap that fits a slot
+ */
+static bool is_cached(const lv_font_glyph_dsc_t * dsc)
+{
+    uint32_t px = (uint32_t)dsc->box_w * dsc->box_h;
+    return LV_PORT_FONT_CACHE_SIZE > 0 && dsc->bpp < 8 && px > 0 && px <= LV_PORT_FONT_CACHE_SLOT;
+}
+
+/**
+ * @brief Expand a packed glyph bitmap to one opacity byte per pixel
+ * @param src Bitmap, rows not padded, first pixel in the most significant bits
+ * @param bpp Bits per pixel of src (3 is stored as 4, like LVGL draws it)
+ * @param px Number of pixels (box_w * box_h)
+ * @param dst Output: px opacity values
+ * @note Values are scaled to 0..255 (4 bpp: x17), as LVGL's 4 bpp opacity table does
+ */
+static void expand(const uint8_t * src, uint8_t bpp, uint32_t px, uint8_t * dst)
+{
+    if (bpp == 3) {
+        bpp = 4;
+    }
+
+    uint32_t mask = (1u << bpp) - 1;
+    uint32_t scale = 255 / mask;
+    uint32_t bit = 0;
+    for (uint32_t i = 0; i < px; i++) {
+        uint32_t v = (src[bit >> 3] >> (8 - bpp - (bit & 7))) & mask;
+        dst[i] = (uint8_t)(v * scale);
+        bit += bpp;
+    }
+}
@@ -0,0 +1,86 @@
+/**
+ * @file lv_port_font.h
+ * @brief LVGL Font Porting Layer: RAM cache of expanded glyph bitmaps
+ * @note The fonts generated by tools/font_subset.py use the two callbacks below instead of
+ *       lv_font_get_glyph_dsc_fmt_txt() and lv_font_get_bitmap_fmt_txt()
+ * @author NIGHT
+ * @date 2025-10-27
+ */
+
+#ifndef LV_PORT_FONT_H
+#define LV_PORT_FONT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#if defined(LV_LVGL_H_INCLUDE_SIMPLE)
+#include "lvgl.h"
+#else
+#include "lvgl/lvgl.h"
+#endif
+#include <stdbool.h>
+
+/*********************
+ *      DEFINES
+ *********************/
+/* Number of cached glyphs (all fonts together), 0 disables the cache */
+#ifndef LV_PORT_FONT_CACHE_SIZE
+#define LV_PORT_FONT_CACHE_SIZE     32
+#endif
+
+/* Bytes per cache entry: glyphs with a larger box (one byte per pixel) are not cached */
+#ifndef LV_PORT_FONT_CACHE_SLOT
+#define LV_PORT_FONT_CACHE_SLOT     192
+#endif
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+/**
+ * @brief Glyph cache statistics
+ */
+typedef struct {
+    uint32_t hits;              // Bitmaps served from the cache
+    uint32_t misses;            // Bitmaps expanded into the cache
+    uint32_t uncached;          // Bitmaps too large for a slot, read from the font
+} lv_port_font_stats_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+/**
+ * @brief Glyph descriptor callback of the generated fonts (lv_font_t.get_glyph_dsc)
+ * @param font Font
+ * @param dsc_out Output parameter: glyph descriptor
+ * @param letter Unicode code point
+ * @param letter_next Following code point (kerning)
+ * @return true if the font has the glyph
+ * @note Glyphs that fit a cache slot are reported with bpp 8, their bitmap comes from the cache
+ */
+bool lv_port_font_get_glyph_dsc(const lv_font_t * font, lv_font_glyph_dsc_t * dsc_out,
+                                uint32_t letter, uint32_t letter_next);
+
+/**
+ * @brief Glyph bitmap callback of the generated fonts (lv_font_t.get_glyph_bitmap)
+ * @param font Font
+ * @param letter Unicode code point
+ * @return Bitmap in the bpp reported by lv_port_font_get_glyph_dsc(), NULL if there is none
+ */
+const uint8_t * lv_port_font_get_glyph_bitmap(const lv_font_t * font, uint32_t letter);
+
+/**
+ * @brief Get glyph cache statistics
+ * @param out Output parameter: counters since the last reset
+ * @param reset Clear the counters after reading
+ */
+void lv_port_font_get_stats(lv_port_font_stats_t * out, bool reset);
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /*LV_PORT_FONT_H*/
@@ -0,0 +1,315 @@
+/**
+ * @file lv_port_img.c
+ * @brief LVGL Image Porting Layer: compressed (RLE565) and palette (I8_565) images and their decoder
+ * @note Rows are decoded on demand, either by lv_port_draw.c straight into the draw buffer
+ *       or by LVGL through the decoder's read_line callback (rotated, zoomed, recolored draws)
+ * @author NIGHT
+ * @date 2025-10-27
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "lv_port_img.h"
+#include "pico/stdlib.h"
+#include "hardware/interp.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define OP_RUN          0x80
+#define OP_LUMA         0xC0
+#define OP_LITERAL      0xFF
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void rle_decode(const lv_img_dsc_t * img, lv_coord_t x, lv_coord_t y, lv_coord_t len,
+                       lv_color_t * dst);
+static void i8_decode(const lv_img_dsc_t * img, lv_coord_t x, lv_coord_t y, lv_coord_t len,
+                      lv_color_t * dst);
+static void i8_interp_setup(const uint16_t * palette);
+static lv_res_t rle_info(lv_img_decoder_t * decoder, const void * src, lv_img_header_t * header);
+static lv_res_t rle_open(lv_img_decoder_t * decoder, lv_img_decoder_dsc_t * dsc);
+static lv_res_t rle_read_line(lv_img_decoder_t * decoder, lv_img_decoder_dsc_t * dsc,
+                              lv_coord_t x, lv_coord_t y, lv_coord_t len, uint8_t * buf);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static lv_port_img_stats_t stats;
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+/**
+ * @brief Register the decoder for RLE565 and I8_565 images
+ */
+void lv_port_img_init(void)
+{
+    lv_img_decoder_t * dec = lv_img_decoder_create();
+    lv_img_decoder_set_info_cb(dec, rle_info);
+    lv_img_decoder_set_open_cb(dec, rle_open);
+    lv_img_decoder_set_read_line_cb(dec, rle_read_line);
+}
+
+/**
+ * @brief Check whether an image source is in one of the formats of this file
+ * @param src Image source
+ * @return true for an lv_img_dsc_t with LV_PORT_IMG_CF_RLE565 or LV_PORT_IMG_CF_I8_565
+ */
+bool lv_port_img_is_encoded(const void * src)
+{
+    if (lv_img_src_get_type(src) != LV_IMG_SRC_VARIABLE) {
+        return false;
+    }
+
+    uint32_t cf = ((const lv_img_dsc_t *)src)->header.cf;
+    return cf == LV_PORT_IMG_CF_RLE565 || cf == LV_PORT_IMG_CF_I8_565;
+}
+
+/**
+ * @brief Decode part of one row of an RLE565 or I8_565 image
+ * @param img Image
+ * @param x First pixel in the row
+ * @param y Row
+ * @param len Number of pixels
+ * @param dst Output: len pixels in lv_color_t format
+ */
+void lv_port_img_decode(const lv_img_dsc_t * img, lv_coord_t x, lv_coord_t y, lv_coord_t len,
+                        lv_color_t * dst)
+{
+    uint32_t start = time_us_32();
+
+    if (img->header.cf == LV_PORT_IMG_CF_I8_565) {
+        i8_decode(img, x, y, len, dst);
+    } else {
+        rle_decode(img, x, y, len, dst);
+    }
+
+    stats.decode_px += len;
+    stats.decode_us += time_us_32() - start;
+}
+
+/**
+ * @brief Get decode statistics
+ * @param out Output parameter: counters since the last reset
+ * @param reset Clear the counters after reading
+ */
+void lv_port_img_get_stats(lv_port_img_stats_t * out, bool reset)
+{
+    *out = stats;
+    if (reset) {
+        stats.decode_px = 0;
+        stats.decode_us = 0;
+    }
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+/**
+ * @brief Decode part of one row of an RLE565 image
+ * @param img Image
+ * @param x First pixel in the row
+ * @param y Row
+ * @param len Number of pixels
+ * @param dst Output: len pixels in lv_color_t format
+ * @note The row is decoded from its start, pixels before x are only skipped
+ */
+static void rle_decode(const lv_img_dsc_t * img, lv_coord_t x, lv_coord_t y, lv_coord_t len,
+                       lv_color_t * dst)
+{
+    const uint32_t * rows = (const uint32_t *)img->data;
+    const uint8_t * p = img->data + img->header.h * sizeof(uint32_t) + rows[y];
+
+    int32_t r = 0, g = 0, b = 0;
+    uint16_t px = 0;
+    int32_t skip = x;
+    int32_t left = len;
+
+    while (left > 0) {
+        uint8_t op = *p++;
+        int32_t n = 1;
+
+        // 1. Next pixel value (and how often it repeats)
+        if (op < OP_RUN) {
+            r += ((op >> 5) & 0x03) - 2;
+            g += ((op >> 2) & 0x07) - 4;
+            b += (op & 0x03) - 2;
+        } else if (op < OP_LUMA) {
+            n = (op & 0x3F) + 1;
+        } else if (op != OP_LITERAL) {
+            int32_t dg = (int32_t)(op & 0x3F) - 32;
+            uint8_t rb = *p++;
+            g += dg;
+            r += (rb >> 4) - 8 + (dg >> 1);
+            b += (rb & 0x0F) - 8 + (dg >> 1);
+        } else {
+            px = p[0] | ((uint16_t)p[1] << 8);
+            p += 2;
+            r = px >> 11;
+            g = (px >> 5) & 0x3F;
+            b = px & 0x1F;
+        }
+        if (op < OP_RUN || (op >= OP_LUMA && op != OP_LITERAL)) {
+            px = (uint16_t)((r << 11) | (g << 5) | b);
+        }
+
+        // 2. Skip pixels left of x, write the rest
+        if (skip >= n) {
+            skip -= n;
+            continue;
+        }
+        n -= skip;
+        skip = 0;
+        if (n > left) {
+            n = left;
+        }
+        left -= n;
+
+#if LV_COLOR_16_SWAP
+        uint16_t full = (uint16_t)((px >> 8) | (px << 8));
+#else
+        uint16_t full = px;
+#endif
+        while (n-- > 0) {
+            (dst++)->full = full;
+        }
+    }
+}
+
+/**
+ * @brief Expand part of one row of an I8_565 image through its palette
+ * @param img Image
+ * @param x First pixel in the row
+ * @param y Row
+ * @param len Number of pixels
+ * @param dst Output: len pixels in lv_color_t format
+ * @note Four indices are read as one word. interp0 turns bytes 0 and 1 into palette
+ *       addresses, interp1 bytes 2 and 3, so the CPU only loads and stores the colors
+ */
+static void i8_decode(const lv_img_dsc_t * img, lv_coord_t x, lv_coord_t y, lv_coord_t len,
+                      lv_color_t * dst)
+{
+    const uint16_t * palette = (const uint16_t *)img->data;
+    const uint8_t * src = img->data + LV_PORT_IMG_I8_PALETTE_SIZE + (uint32_t)y * img->header.w + x;
+    uint16_t * out = (uint16_t *)dst;
+
+    // 1. Indices up to the next word boundary
+    while (len > 0 && ((uintptr_t)src & 3)) {
+        *out++ = palette[*src++];
+        len--;
+    }
+
+    // 2. Four pixels per word
+    i8_interp_setup(palette);
+    const uint32_t * words = (const uint32_t *)src;
+    for (; len >= 4; len -= 4) {
+        uint32_t w = *words++;
+        interp0->accum[0] = w << 1;     // Byte 0 at bits 8:1, byte 1 at bits 16:9
+        interp1->accum[0] = w >> 15;    // Byte 2 at bits 8:1, byte 3 at bits 16:9
+        out[0] = *(const uint16_t *)interp0->peek[0];
+        out[1] = *(const uint16_t *)interp0->peek[1];
+        out[2] = *(const uint16_t *)interp1->peek[0];
+        out[3] = *(const uint16_t *)interp1->peek[1];
+        out += 4;
+    }
+
+    // 3. Remaining indices
+    src = (const uint8_t *)words;
+    while (len-- > 0) {
+        *out++ = palette[*src++];
+    }
+}
+
+/**
+ * @brief Configure interp0 and interp1 of this core as palette lookups
+ * @param palette Palette (256 entries of 2 bytes)
+ * @note Lane 0 maps accumulator 0 bits 8:1 to palette + index * 2, lane 1 does the same
+ *       for bits 16:9 (cross input from accumulator 0). Set on every call, the
+ *       interpolators are per core and not saved by the scheduler
+ */
+static void i8_interp_setup(const uint16_t * palette)
+{
+    interp_config lane0 = interp_default_config();
+    interp_config_set_shift(&lane0, 0);
+    interp_config_set_mask(&lane0, 1, 8);
+
+    interp_config lane1 = interp_default_config();
+    interp_config_set_cross_input(&lane1, true);
+    interp_config_set_shift(&lane1, 8);
+    interp_config_set_mask(&lane1, 1, 8);
+
+    interp_set_config(interp0, 0, &lane0);
+    interp_set_config(interp0, 1, &lane1);
+    interp_set_config(interp1, 0, &lane0);
+    interp_set_config(interp1, 1, &lane1);
+
+    interp0->base[0] = (uintptr_t)palette;
+    interp0->base[1] = (uintptr_t)palette;
+    interp1->base[0] = (uintptr_t)palette;
+    interp1->base[1] = (uintptr_t)palette;
+}
+
+/**
+ * @brief Decoder info callback
+ * @param decoder Decoder
+ * @param src Image source
+ * @param header Output parameter: image header
+ * @return LV_RES_OK for RLE565 and I8_565 images, LV_RES_INV for other sources
+ * @note Reported as LV_IMG_CF_TRUE_COLOR, so LVGL draws it like an opaque raw image
+ */
+static lv_res_t rle_info(lv_img_decoder_t * decoder, const void * src, lv_img_header_t * header)
+{
+    (void)decoder;
+
+    if (!lv_port_img_is_encoded(src)) {
+        return LV_RES_INV;
+    }
+
+    *header = ((const lv_img_dsc_t *)src)->header;
+    header->cf = LV_IMG_CF_TRUE_COLOR;
+    return LV_RES_OK;
+}
+
+/**
+ * @brief Decoder open callback
+ * @param decoder Decoder
+ * @param dsc Decoder descriptor
+ * @return LV_RES_OK for RLE565 and I8_565 images, LV_RES_INV for other sources
+ * @note No decoded frame is kept (it would take 300 KB of RAM), img_data stays NULL and
+ *       LVGL reads the image line by line
+ */
+static lv_res_t rle_open(lv_img_decoder_t * decoder, lv_img_decoder_dsc_t * dsc)
+{
+    (void)decoder;
+
+    if (!lv_port_img_is_encoded(dsc->src)) {
+        return LV_RES_INV;
+    }
+
+    dsc->img_data = NULL;
+    return LV_RES_OK;
+}
+
+/**
+ * @brief Decoder read line callback
+ * @param decoder Decoder
+ * @param dsc Decoder descriptor
+ * @param x First pixel
+ * @param y Row
+ * @param len Number of pixels
+ * @param buf Output: len pixels in lv_color_t format
+ * @return LV_RES_OK
+ */
+static lv_res_t rle_read_line(lv_img_decoder_t * decoder, lv_img_decoder_dsc_t * dsc,
+                              lv_coord_t x, lv_coord_t y, lv_coord_t len, uint8_t * buf)
+{
+    (void)decoder;
+
+    lv_port_img_decode((const lv_img_dsc_t *)dsc->src, x, y, len, (lv_color_t *)buf);
+    return LV_RES_OK;
+}
@@ -0,0 +1,99 @@
+/**
+ * @file lv_port_img.h
+ * @brief LVGL Image Porting Layer: compressed (RLE565) and palette (I8_565) images and their decoder
+ * @author NIGHT
+ * @date 2025-10-27
+ */
+
+#ifndef LV_PORT_IMG_H
+#define LV_PORT_IMG_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#if defined(LV_LVGL_H_INCLUDE_SIMPLE)
+#include "lvgl.h"
+#else
+#include "lvgl/lvgl.h"
+#endif
+#include <stdbool.h>
+
+/*********************
+ *      DEFINES
+ *********************/
+/* Color format of RLE565 images (tools/img_conv.py --compress rle565, encoder in tools/img_rle.py)
+ *
+ * data: uint32_t row offset[h] (little endian, relative to the op stream), then the op stream.
+ * Each row starts with previous pixel = 0 so rows decode independently. Ops:
+ *   0xxxxxxx  DIFF     r += bits 6..5 - 2, g += bits 4..2 - 4, b += bits 1..0 - 2
+ *   10nnnnnn  RUN      previous pixel n + 1 more times
+ *   11gggggg  LUMA     g += gggggg - 32 (0..62), next byte: r += hi - 8 + dg/2, b += lo - 8 + dg/2
+ *   11111111  LITERAL  next 2 bytes: RGB565, little endian
+ */
+#define LV_PORT_IMG_CF_RLE565       LV_IMG_CF_USER_ENCODED_0
+
+/* Color format of 8-bit palette images (tools/img_conv.py --compress index8)
+ *
+ * data: uint16_t palette[256] (lv_color_t values, already in LV_COLOR_16_SWAP order),
+ * then one palette index per pixel, row by row. Rows are expanded by the interpolators.
+ */
+#define LV_PORT_IMG_CF_I8_565       LV_IMG_CF_USER_ENCODED_1
+
+/* Palette size at the start of I8_565 data [bytes] */
+#define LV_PORT_IMG_I8_PALETTE_SIZE (256 * sizeof(uint16_t))
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+/**
+ * @brief Decode statistics (both formats)
+ */
+typedef struct {
+    uint32_t decode_px;         // Pixels decoded
+    uint32_t decode_us;         // Time spent decoding
+} lv_port_img_stats_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+/**
+ * @brief Register the decoder for RLE565 and I8_565 images
+ * @note Call after lv_init()
+ */
+void lv_port_img_init(void);
+
+/**
+ * @brief Check whether an image source is in one of the formats of this file
+ * @param src Image source (as passed to lv_img_set_src())
+ * @return true for an lv_img_dsc_t with LV_PORT_IMG_CF_RLE565 or LV_PORT_IMG_CF_I8_565
+ */
+bool lv_port_img_is_encoded(const void * src);
+
+/**
+ * @brief Decode part of one row of an RLE565 or I8_565 image
+ * @param img Image
+ * @param x First pixel in the row
+ * @param y Row
+ * @param len Number of pixels
+ * @param dst Output: len pixels in lv_color_t format
+ * @note I8_565 uses interp0 and interp1 of the calling core
+ */
+void lv_port_img_decode(const lv_img_dsc_t * img, lv_coord_t x, lv_coord_t y, lv_coord_t len,
+                        lv_color_t * dst);
+
+/**
+ * @brief Get decode statistics
+ * @param out Output parameter: counters since the last reset
+ * @param reset Clear the counters after reading
+ */
+void lv_port_img_get_stats(lv_port_img_stats_t * out, bool reset);
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /*LV_PORT_IMG_H*/
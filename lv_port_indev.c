@@ -10,14 +10,82 @@
  *      INCLUDES
  *********************/
 #include "lv_port_indev.h"
+#include "lv_port_cmd.h"
 #include "lvgl.h"
 #include "gt911.h"
+#include "touch_gesture.h"
+#include "st7796.h"
+#include "pico/stdlib.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "hardware/sync.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+/*********************
+ *      DEFINES
+ *********************/
+/* While pressed, read at least this often in case the INT edge of the release report is missed */
+#define TOUCH_PRESSED_TIMEOUT_MS    50
+
+/* Polling period of the touch task while released (no INT line) */
+#define TOUCH_IDLE_POLL_MS          20
+
+/* Touch task priority, above the LVGL task (2) so a report is never left waiting */
+#define TOUCH_TASK_PRIO             5
+
+/* Queued touch samples (power of two). 16 reports cover 160 ms of LVGL not reading */
+#define TOUCH_RING_SIZE             16
+
+/* Pending predictions kept to score them against the position actually reached */
+#define FILTER_EVAL_SLOTS           8
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+/**
+ * @brief Touch report queued by the touch task
+ */
+typedef struct {
+    gt911_touch_t touch;    // All tracked points
+    uint32_t t_us;          // INT edge timestamp of this report, or its read time when polling
+} touch_sample_t;
+
+#if LV_PORT_INDEV_FILTER && LV_PORT_INDEV_PERF_LOG
+/**
+ * @brief Prediction waiting for the sample at its target time
+ */
+typedef struct {
+    uint32_t target_us;     // Sample time + predict_ms
+    int16_t pred_x;         // Predicted position
+    int16_t pred_y;
+    int16_t raw_x;          // Raw position when predicted (what an unfiltered pointer shows)
+    int16_t raw_y;
+} filter_eval_t;
+#endif
 
 /**********************
  *  STATIC PROTOTYPES
  **********************/
 static void touchpad_init(void);
 static void touchpad_read(lv_indev_drv_t *indev_drv, lv_indev_data_t *data);
+static void touch_int_cb(void);
+static void touch_task(void *param);
+static bool touch_ring_push(const touch_sample_t *sample);
+static bool touch_queue(const touch_sample_t *sample, bool *pressed);
+static bool touch_ring_pop(touch_sample_t *sample);
+static void touch_gesture_feed(const gt911_touch_t *touch);
+#if LV_PORT_EVENT_DRIVEN
+static void touch_read_pause(lv_timer_t *read_timer);
+#endif
+#if LV_PORT_INDEV_FILTER
+static void touch_filter_apply(int16_t raw_x, int16_t raw_y, uint32_t t_us, bool down,
+                               int16_t *out_x, int16_t *out_y);
+#if LV_PORT_INDEV_PERF_LOG
+static void filter_eval(int16_t raw_x, int16_t raw_y, uint32_t t_us, int16_t pred_x, int16_t pred_y);
+static void filter_eval_report(void);
+#endif
+#endif
 
 /**********************
  *  STATIC VARIABLES
@@ -27,6 +95,45 @@ lv_indev_t *indev_touchpad;
 /* Store last touch coordinates */
 static int16_t last_x = 0;
 static int16_t last_y = 0;
+static bool last_pressed = false;
+
+/* Touch task and the samples it queued for touchpad_read() (single producer, single consumer) */
+static TaskHandle_t touch_handle = NULL;
+static bool touch_int_mode = false;         // Woken by INT, otherwise polls the GT911
+static touch_sample_t touch_ring[TOUCH_RING_SIZE];
+static volatile uint32_t touch_head = 0;    // Written by touch_task() only
+static volatile uint32_t touch_tail = 0;    // Written by touchpad_read() only
+static volatile uint32_t touch_irq_us = 0;
+static volatile uint32_t touch_read_us = 0;
+static volatile uint32_t touch_drops = 0;   // Reports replaced by a newer one while the ring was full
+static volatile bool touch_kick = false;    // Set by touch_task(), lv_port_indev_process() readies the read timer
+#if LV_PORT_EVENT_DRIVEN
+static volatile bool touch_read_paused = false; // Read timer paused by touchpad_read(), written by the LVGL task only
+#endif
+
+/* Two-finger gesture callback (LVGL context) */
+static lv_port_indev_gesture_cb_t gesture_cb = NULL;
+
+#if LV_PORT_INDEV_FILTER
+/* Touch filter parameters and state */
+static lv_port_indev_filter_t filter_cfg = {
+    .min_cutoff = LV_PORT_INDEV_FILTER_MIN_CUTOFF,
+    .beta = LV_PORT_INDEV_FILTER_BETA,
+    .d_cutoff = LV_PORT_INDEV_FILTER_D_CUTOFF,
+    .predict_ms = LV_PORT_INDEV_PREDICT_MS,
+    .predict_max_px = LV_PORT_INDEV_PREDICT_MAX_PX,
+};
+static touch_filter_t filter;           // State of the current touch, with the parameters it started with
+
+#if LV_PORT_INDEV_PERF_LOG
+/* Online scoring: sum of |predicted - reached| vs |raw - reached| over one touch */
+static filter_eval_t eval_slots[FILTER_EVAL_SLOTS];
+static uint8_t eval_count = 0;
+static uint32_t eval_err_filter = 0;
+static uint32_t eval_err_raw = 0;
+static uint32_t eval_samples = 0;
+#endif
+#endif
 
 /**********************
  *   GLOBAL FUNCTIONS
@@ -49,17 +156,120 @@ void lv_port_indev_init(void)
     indev_touchpad = lv_indev_drv_register(&indev_drv);
 }
 
+/**
+ * @brief Hand a press or release queued by the touch task to LVGL at once (LVGL task)
+ * @note lv_timer_ready() only rewinds the read timer's last run tick, so the next
+ *       lv_timer_handler() reads the report instead of waiting for the read period.
+ *       In event-driven mode it also restarts the read timer paused by touchpad_read()
+ */
+void lv_port_indev_process(void)
+{
+    if (!touch_kick || indev_touchpad == NULL) {
+        return;
+    }
+    touch_kick = false;
+    
+#if LV_PORT_EVENT_DRIVEN
+    touch_read_paused = false;
+    lv_timer_resume(indev_touchpad->driver->read_timer);
+#endif
+    lv_timer_ready(indev_touchpad->driver->read_timer);
+}
+
+/**
+ * @brief Set the two-finger gesture callback
+ * @param cb Called from touchpad_read() (LVGL context) for each gesture report, NULL to disable
+ */
+void lv_port_indev_set_gesture_cb(lv_port_indev_gesture_cb_t cb)
+{
+    gesture_cb = cb;
+}
+
+/**
+ * @brief Map the touch controller to the current display orientation
+ * @return false if the GT911 config could not be written
+ * @note The GT911 swaps and mirrors its axes and scales to the display resolution itself,
+ *       so touchpad_read() needs no transform per sample
+ */
+bool lv_port_indev_update_orientation(void)
+{
+#if LV_PORT_INDEV_GT911_CONFIG
+    gt911_config_t cfg = {
+        .report_ms = LV_PORT_INDEV_REPORT_MS,
+    };
+    
+    // Relative to portrait, matching the MADCTL settings in st7796_set_orientation()
+    switch (st7796_get_orientation()) {
+        case ST7796_LANDSCAPE:
+            cfg.swap_xy = true;
+            cfg.mirror_y = true;
+            break;
+        case ST7796_PORTRAIT_INV:
+            cfg.mirror_x = true;
+            cfg.mirror_y = true;
+            break;
+        case ST7796_LANDSCAPE_INV:
+            cfg.swap_xy = true;
+            cfg.mirror_x = true;
+            break;
+        case ST7796_PORTRAIT:
+        default:
+            break;
+    }
+    cfg.x_max = cfg.swap_xy ? ST7796_HEIGHT : ST7796_WIDTH;
+    cfg.y_max = cfg.swap_xy ? ST7796_WIDTH : ST7796_HEIGHT;
+    
+    // The config fresh flag is the last byte written, so a failed write leaves the GT911
+    // on its previous config (resolution, axes and report rate as before)
+    if (!gt911_write_config(&cfg)) {
+        printf("touch: GT911 config write failed, keeping its previous config\n");
+        return false;
+    }
+#endif
+    return true;
+}
+
+/**
+ * @brief Change the touch filter parameters
+ * @param cfg New parameters (copied)
+ */
+void lv_port_indev_set_filter(const lv_port_indev_filter_t *cfg)
+{
+#if LV_PORT_INDEV_FILTER
+    filter_cfg = *cfg;
+#else
+    (void)cfg;
+#endif
+}
+
 /**********************
  *   STATIC FUNCTIONS
  **********************/
 
 /**
  * @brief Initialize GT911 touch driver
+ * @note A touch task reads every GT911 report and queues it for touchpad_read(). With the INT
+ *       line wired it runs only when the GT911 signals a report, otherwise it polls
  */
 static void touchpad_init(void)
 {
     if (!gt911_init()) {
         // TODO: Add error handling if needed
+        return;
+    }
+    
+    // Resolution, axes and report rate for the orientation set by st7796_init(). On failure
+    // (logged) touch still runs, with the mapping and report rate the GT911 already had
+    (void)lv_port_indev_update_orientation();
+    
+    if (xTaskCreate(touch_task, "touch", 512, NULL, TOUCH_TASK_PRIO, &touch_handle) != pdPASS) {
+        touch_handle = NULL;
+        return;
+    }
+    
+    // Falls back to polling if the INT line is not wired
+    if (gt911_int_available()) {
+        touch_int_mode = gt911_int_enable(touch_int_cb);
     }
 }
 
@@ -67,34 +277,387 @@ static void touchpad_init(void)
  * @brief Read touch data and update LVGL input state
  * @param indev_drv Input device driver pointer
  * @param data Output data structure for LVGL
- * @note Called periodically by LVGL to poll touch state
+ * @note Called periodically by LVGL, never touches the I2C bus. Each call hands over the oldest
+ *       queued report and sets continue_reading while more are waiting, so LVGL sees every
+ *       report (velocity, scroll throw) and not only the latest one
  */
 static void touchpad_read(lv_indev_drv_t *indev_drv, lv_indev_data_t *data)
 {
-    uint16_t x, y;
-    bool pressed;
+    touch_sample_t sample;
     
-    data->continue_reading = false;
+    (void)indev_drv;
     
-    if (gt911_read_touch(&x, &y, &pressed)) {
-        if (pressed) {
-            // Touch detected: update coordinates and state
-            data->point.x = x;
-            data->point.y = y;
-            data->state = LV_INDEV_STATE_PR;
-            
-            last_x = x;
-            last_y = y;
-        } else {
-            // No touch: return last coordinates with released state
-            data->point.x = last_x;
-            data->point.y = last_y;
-            data->state = LV_INDEV_STATE_REL;
+#if LV_PORT_INDEV_PERF_LOG
+    static uint32_t perf_reads = 0;     // LVGL reads during the current touch
+    static uint32_t perf_samples = 0;   // Reports handed over during the current touch
+    if (last_pressed) {
+        perf_reads++;
+    }
+#endif
+    
+    // 1. Nothing queued: repeat the last state
+    if (!touch_ring_pop(&sample)) {
+        data->point.x = last_x;
+        data->point.y = last_y;
+        data->state = last_pressed ? LV_INDEV_STATE_PR : LV_INDEV_STATE_REL;
+        data->continue_reading = false;
+#if LV_PORT_EVENT_DRIVEN
+        // Released and idle: no more timer runs until touch_task() queues a report
+        if (!last_pressed) {
+            touch_read_pause(indev_drv->read_timer);
         }
+#endif
+        return;
+    }
+    data->continue_reading = (touch_tail != touch_head);
+    
+    const gt911_touch_t *touch = &sample.touch;
+    
+#if LV_PORT_INDEV_PERF_LOG
+    if (touch->count > 0 && !last_pressed) {
+        printf("touch: down latency %lu us (%s to LVGL read), I2C read %lu us\n",
+               (unsigned long)(time_us_32() - sample.t_us),
+               touch_int_mode ? "INT" : "poll",
+               (unsigned long)touch_read_us);
+        perf_reads = 1;
+        perf_samples = 0;
+    }
+    perf_samples++;
+    if (touch->count == 0 && last_pressed) {
+        printf("touch: %lu reports in %lu LVGL reads, %lu dropped\n",
+               (unsigned long)perf_samples, (unsigned long)perf_reads,
+               (unsigned long)touch_drops);
+    }
+#endif
+    
+    // 2. Hand the report to LVGL
+    if (touch->count > 0) {
+        // Touch detected: LVGL gets the first point
+        int16_t x = touch->points[0].x;
+        int16_t y = touch->points[0].y;
+        
+#if LV_PORT_INDEV_FILTER
+        // Smooth and extrapolate, a new touch restarts the filter at the raw point
+        touch_filter_apply(x, y, sample.t_us, !last_pressed, &x, &y);
+#endif
+        
+        data->point.x = x;
+        data->point.y = y;
+        data->state = LV_INDEV_STATE_PR;
+        
+        last_x = x;
+        last_y = y;
+        last_pressed = true;
     } else {
-        // Read failed: return last coordinates with released state
+        // Released or read failed: return last coordinates with released state
         data->point.x = last_x;
         data->point.y = last_y;
         data->state = LV_INDEV_STATE_REL;
+        
+#if LV_PORT_INDEV_FILTER && LV_PORT_INDEV_PERF_LOG
+        if (last_pressed) {
+            filter_eval_report();
+        }
+#endif
+        last_pressed = false;
     }
-}
\ No newline at end of file
+    
+    touch_gesture_feed(touch);
+}
+
+/**
+ * @brief Run the gesture recognizer on a report and call the gesture callback
+ * @param touch Touch report
+ */
+static void touch_gesture_feed(const gt911_touch_t *touch)
+{
+    touch_gesture_t gesture;
+    
+    if (gesture_cb == NULL) {
+        return;
+    }
+    
+    if (touch_gesture_update(touch, &gesture)) {
+        gesture_cb(&gesture);
+    }
+}
+
+#if LV_PORT_INDEV_FILTER
+/**
+ * @brief Filter one touch sample (touch_filter.c) and keep it on the screen
+ * @param raw_x Raw X coordinate
+ * @param raw_y Raw Y coordinate
+ * @param t_us Sample time (INT edge or poll time)
+ * @param down true for the first sample of a touch
+ * @param out_x Output parameter: filtered and extrapolated X
+ * @param out_y Output parameter: filtered and extrapolated Y
+ */
+static void touch_filter_apply(int16_t raw_x, int16_t raw_y, uint32_t t_us, bool down,
+                               int16_t *out_x, int16_t *out_y)
+{
+    if (down) {
+        // Parameters only change between touches
+        touch_filter_start(&filter, &filter_cfg, raw_x, raw_y, t_us);
+#if LV_PORT_INDEV_PERF_LOG
+        eval_count = 0;
+        eval_err_filter = 0;
+        eval_err_raw = 0;
+        eval_samples = 0;
+#endif
+        *out_x = raw_x;
+        *out_y = raw_y;
+        return;
+    }
+    
+    // Two reports with the same timestamp repeat the output and are not scored again
+    bool repeat = (t_us == filter.t_us);
+    int16_t x, y;
+    touch_filter_update(&filter, raw_x, raw_y, t_us, &x, &y);
+    
+    // The extrapolation can point past the edge
+    lv_disp_t *disp = lv_disp_get_default();
+    lv_coord_t w = disp ? lv_disp_get_hor_res(disp) : INT16_MAX;
+    lv_coord_t h = disp ? lv_disp_get_ver_res(disp) : INT16_MAX;
+    x = LV_CLAMP(0, x, w - 1);
+    y = LV_CLAMP(0, y, h - 1);
+    
+#if LV_PORT_INDEV_PERF_LOG
+    if (!repeat) {
+        filter_eval(raw_x, raw_y, t_us, x, y);
+    }
+#else
+    (void)repeat;
+#endif
+    
+    *out_x = x;
+    *out_y = y;
+}
+
+#if LV_PORT_INDEV_PERF_LOG
+/**
+ * @brief Score earlier predictions against the position reached now
+ * @param raw_x Raw X coordinate of this sample
+ * @param raw_y Raw Y coordinate of this sample
+ * @param t_us Sample time
+ * @param pred_x Output of the filter for this sample
+ * @param pred_y Output of the filter for this sample
+ * @note Compares each prediction with the first sample at or after its target time, and the
+ *       unfiltered pointer (raw position at prediction time) with the same sample
+ */
+static void filter_eval(int16_t raw_x, int16_t raw_y, uint32_t t_us, int16_t pred_x, int16_t pred_y)
+{
+    uint8_t keep = 0;
+    
+    for (uint8_t i = 0; i < eval_count; i++) {
+        filter_eval_t *e = &eval_slots[i];
+        if ((int32_t)(t_us - e->target_us) >= 0) {
+            eval_err_filter += abs(e->pred_x - raw_x) + abs(e->pred_y - raw_y);
+            eval_err_raw += abs(e->raw_x - raw_x) + abs(e->raw_y - raw_y);
+            eval_samples++;
+        } else {
+            eval_slots[keep++] = *e;
+        }
+    }
+    eval_count = keep;
+    
+    if (eval_count < FILTER_EVAL_SLOTS) {
+        eval_slots[eval_count++] = (filter_eval_t){
+            .target_us = t_us + filter.cfg.predict_ms * 1000u,
+            .pred_x = pred_x,
+            .pred_y = pred_y,
+            .raw_x = raw_x,
+            .raw_y = raw_y,
+        };
+    }
+}
+
+/**
+ * @brief Print the prediction error of the touch that just ended
+ */
+static void filter_eval_report(void)
+{
+    if (eval_samples == 0) {
+        return;
+    }
+    
+    printf("touch: filter error %lu.%02lu px, raw pointer %lu.%02lu px (mean over %lu samples, "
+           "%u ms ahead)\n",
+           (unsigned long)(eval_err_filter / eval_samples),
+           (unsigned long)(eval_err_filter * 100 / eval_samples % 100),
+           (unsigned long)(eval_err_raw / eval_samples),
+           (unsigned long)(eval_err_raw * 100 / eval_samples % 100),
+           (unsigned long)eval_samples,
+           filter.cfg.predict_ms);
+}
+#endif
+#endif
+
+/**
+ * @brief GT911 INT callback
+ * @note Runs in GPIO IRQ context, wakes the touch task
+ */
+static void touch_int_cb(void)
+{
+    BaseType_t woken = pdFALSE;
+    
+    if (xTaskGetSchedulerState() == taskSCHEDULER_NOT_STARTED) {
+        return;     // Reports repeat every few ms while touched
+    }
+    
+    touch_irq_us = time_us_32();
+    vTaskNotifyGiveFromISR(touch_handle, &woken);
+    portYIELD_FROM_ISR(woken);
+}
+
+/**
+ * @brief Touch task: reads each GT911 report and queues it for touchpad_read()
+ * @param param Unused
+ * @note Runs when INT fires, or every LV_PORT_INDEV_SAMPLE_MS while pressed when polling
+ */
+static void touch_task(void *param)
+{
+    touch_sample_t sample = {0};
+    bool pressed = false;       // State of the last queued report
+    bool pending = false;       // sample could not be queued yet
+    
+    (void)param;
+    
+    for (;;) {
+        // 1. Wait for the next report
+        uint32_t notified = 0;
+        if (touch_int_mode) {
+            // Idle: sleep until INT. Pressed: also wake up periodically so a missed release cannot stick
+            TickType_t timeout = (pressed || pending) ? pdMS_TO_TICKS(TOUCH_PRESSED_TIMEOUT_MS)
+                                                      : portMAX_DELAY;
+            notified = ulTaskNotifyTake(pdTRUE, timeout);
+        } else {
+            vTaskDelay(pdMS_TO_TICKS(pressed ? LV_PORT_INDEV_SAMPLE_MS : TOUCH_IDLE_POLL_MS));
+        }
+        
+        // 2. Read it, the GT911 returns the previous report if there is no new one
+        gt911_touch_t touch;
+        uint32_t count = gt911_get_report_count();
+        uint32_t start = time_us_32();
+        bool ok = gt911_read_points(&touch);
+        touch_read_us = time_us_32() - start;
+        
+        bool fresh;
+        if (ok) {
+            fresh = (gt911_get_report_count() != count);
+        } else {
+            touch.count = 0;    // Treat a failed read as a release
+            fresh = pressed;
+        }
+        
+        if (fresh) {
+            if (pending && (touch.count > 0) != (sample.touch.count > 0)) {
+                // The waiting report has the other pressed state. Replacing it would turn a tap
+                // made while LVGL is busy into a lone release, so wait until LVGL takes it
+                while (!touch_queue(&sample, &pressed)) {
+                    vTaskDelay(pdMS_TO_TICKS(LV_PORT_INDEV_SAMPLE_MS));
+                }
+                pending = false;
+            }
+            if (pending) {
+                touch_drops++;  // Ring still full: keep only the newest report of the same state
+            }
+            sample.touch = touch;
+            sample.t_us = notified ? touch_irq_us : start;
+            pending = true;
+        }
+        
+        // 3. Queue it. When the ring is full it is retried at the next wake-up
+        if (pending && touch_queue(&sample, &pressed)) {
+            pending = false;
+        }
+    }
+}
+
+/**
+ * @brief Queue a report and tell the LVGL task about a press or release (touch task only)
+ * @param sample Report to queue
+ * @param pressed In/out: pressed state of the last queued report
+ * @return true if queued, false if the ring is full
+ */
+static bool touch_queue(const touch_sample_t *sample, bool *pressed)
+{
+    if (!touch_ring_push(sample)) {
+        return false;
+    }
+    
+    // Hand a press or release to LVGL at its next timer run instead of the next read
+    // period. The LVGL task readies the read timer (lv_port_indev_process())
+    bool changed = ((sample->touch.count > 0) != *pressed);
+    *pressed = (sample->touch.count > 0);
+#if LV_PORT_EVENT_DRIVEN
+    // The read timer is paused while released, and the LVGL task may be asleep:
+    // wake it, lv_port_indev_process() resumes the timer. The flag is read after
+    // the report is published, touch_read_pause() checks them in the opposite order
+    __dmb();
+    if (changed || touch_read_paused) {
+        touch_kick = true;
+        lv_port_cmd_wake();
+    }
+#else
+    if (changed) {
+        touch_kick = true;
+    }
+#endif
+    return true;
+}
+
+#if LV_PORT_EVENT_DRIVEN
+/**
+ * @brief Stop the LVGL read timer while nothing is touched (touchpad_read() only)
+ * @param read_timer Read timer of the touch input device
+ * @note Only the LVGL task changes the timer: touch_task() sees touch_read_paused after
+ *       queueing and has lv_port_indev_process() resume it. The flag is set before the ring
+ *       is checked again, so a report queued in between either keeps the timer running or
+ *       finds the flag set
+ */
+static void touch_read_pause(lv_timer_t *read_timer)
+{
+    touch_read_paused = true;
+    __dmb();
+    if (touch_tail != touch_head) {
+        touch_read_paused = false;
+        return;
+    }
+    lv_timer_pause(read_timer);
+}
+#endif
+
+/**
+ * @brief Queue a touch sample (touch task only)
+ * @param sample Sample to copy into the ring
+ * @return true if queued, false if the ring is full
+ */
+static bool touch_ring_push(const touch_sample_t *sample)
+{
+    if (touch_head - touch_tail >= TOUCH_RING_SIZE) {
+        return false;
+    }
+    
+    touch_ring[touch_head % TOUCH_RING_SIZE] = *sample;
+    __dmb();
+    touch_head++;
+    return true;
+}
+
+/**
+ * @brief Take the oldest touch sample (touchpad_read() only)
+ * @param sample Output parameter: oldest queued sample
+ * @return true if a sample was taken, false if the ring is empty
+ */
+static bool touch_ring_pop(touch_sample_t *sample)
+{
+    if (touch_tail == touch_head) {
+        return false;
+    }
+    
+    __dmb();
+    *sample = touch_ring[touch_tail % TOUCH_RING_SIZE];
+    __dmb();
+    touch_tail++;
+    return true;
+}
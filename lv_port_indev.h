@@ -16,6 +16,57 @@ extern "C" {
  *      INCLUDES
  *********************/
 #include "lvgl.h"
+#include "touch_gesture.h"
+#include "touch_filter.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+/* Print touch-down latency (GT911 INT edge to LVGL read) over stdio */
+#ifndef LV_PORT_INDEV_PERF_LOG
+#define LV_PORT_INDEV_PERF_LOG      0
+#endif
+
+/* Sampling period of the touch task without INT line while pressed (GT911 reports at about 100 Hz) */
+#ifndef LV_PORT_INDEV_SAMPLE_MS
+#define LV_PORT_INDEV_SAMPLE_MS     5
+#endif
+
+/* Program the GT911 config for the display orientation (resolution, axis swap/mirror, report rate) */
+#ifndef LV_PORT_INDEV_GT911_CONFIG
+#define LV_PORT_INDEV_GT911_CONFIG  1
+#endif
+
+/* GT911 report interval written to its config [ms], 5 to 20 (5 = fastest, 200 reports/s) */
+#ifndef LV_PORT_INDEV_REPORT_MS
+#define LV_PORT_INDEV_REPORT_MS     5
+#endif
+
+/* Touch filter: 1-euro smoothing plus extrapolation to the expected display time */
+#ifndef LV_PORT_INDEV_FILTER
+#define LV_PORT_INDEV_FILTER        1
+#endif
+
+/* Default filter parameters, can be changed at run time with lv_port_indev_set_filter() */
+#define LV_PORT_INDEV_FILTER_MIN_CUTOFF     1.5f    // [Hz] smoothing at rest, lower = less jitter
+#define LV_PORT_INDEV_FILTER_BETA           0.01f   // [1/px] cutoff increase per px/s, higher = less lag
+#define LV_PORT_INDEV_FILTER_D_CUTOFF       1.0f    // [Hz] smoothing of the velocity estimate
+#define LV_PORT_INDEV_PREDICT_MS            16      // [ms] sample to photon time to extrapolate over
+#define LV_PORT_INDEV_PREDICT_MAX_PX        24      // [px] limit of the extrapolation
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+/**
+ * @brief Two-finger gesture callback
+ * @param gesture Recognized gesture (pinch, scroll or rotate)
+ */
+typedef void (*lv_port_indev_gesture_cb_t)(const touch_gesture_t *gesture);
+
+/**
+ * @brief Touch filter parameters (see touch_filter.h)
+ */
+typedef touch_filter_cfg_t lv_port_indev_filter_t;
 
 /**********************
  * GLOBAL PROTOTYPES
@@ -26,6 +77,34 @@ extern "C" {
  */
 void lv_port_indev_init(void);
 
+/**
+ * @brief Hand a press or release queued by the touch task to LVGL at once
+ * @note Call from the LVGL task before lv_task_handler(). The touch task only sets a flag,
+ *       LVGL timers are not touched outside the LVGL task
+ */
+void lv_port_indev_process(void);
+
+/**
+ * @brief Set the two-finger gesture callback
+ * @param cb Called from the LVGL input read (in the LVGL task) for each gesture report, NULL to disable
+ */
+void lv_port_indev_set_gesture_cb(lv_port_indev_gesture_cb_t cb);
+
+/**
+ * @brief Map the touch controller to the current display orientation
+ * @return false if the GT911 config could not be written, the GT911 keeps its previous config
+ * @note Call after st7796_set_orientation(). The GT911 then reports display coordinates
+ *       itself. Only used with LV_PORT_INDEV_GT911_CONFIG (always true without it)
+ */
+bool lv_port_indev_update_orientation(void);
+
+/**
+ * @brief Change the touch filter parameters
+ * @param cfg New parameters (copied)
+ * @note Takes effect at the next touch-down. Only used with LV_PORT_INDEV_FILTER
+ */
+void lv_port_indev_set_filter(const lv_port_indev_filter_t *cfg);
+
 #ifdef __cplusplus
 } /*extern "C"*/
 #endif
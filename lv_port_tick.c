@@ -0,0 +1,27 @@
+/**
+ * @file lv_port_tick.c
+ * @brief LVGL Tick Porting Layer: LVGL time from the RP2040 64-bit microsecond timer
+ * @note Replaces lv_tick_inc(1) in the FreeRTOS tick hook, which needed a tick interrupt
+ *       every millisecond and stopped counting while the tick was suppressed
+ * @author NIGHT
+ * @date 2025-10-27
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "lv_port_tick.h"
+#include "pico/time.h"
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+/**
+ * @brief Milliseconds since boot (LV_TICK_CUSTOM_SYS_TIME_EXPR)
+ * @return Time in ms
+ */
+uint32_t lv_port_tick_get(void)
+{
+    return (uint32_t)(time_us_64() / 1000);
+}
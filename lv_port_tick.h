@@ -0,0 +1,36 @@
+/**
+ * @file lv_port_tick.h
+ * @brief LVGL Tick Porting Layer: LVGL time from the RP2040 64-bit microsecond timer
+ * @note Included by lv_conf.h (LV_TICK_CUSTOM_INCLUDE) into every LVGL source, so it
+ *       must not include lvgl.h or SDK headers
+ * @author NIGHT
+ * @date 2025-10-27
+ */
+
+#ifndef LV_PORT_TICK_H
+#define LV_PORT_TICK_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdint.h>
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+/**
+ * @brief Milliseconds since boot (LV_TICK_CUSTOM_SYS_TIME_EXPR)
+ * @return Time in ms, wraps after 49 days like lv_tick_get()
+ * @note Always current, also after the CPU slept through FreeRTOS ticks (tickless idle)
+ */
+uint32_t lv_port_tick_get(void);
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /*LV_PORT_TICK_H*/
@@ -15,6 +15,9 @@
 #include "lvgl.h"
 #include "lv_port_disp.h"
 #include "lv_port_indev.h"
+#include "lv_port_cmd.h"
+#include "button_event.h"
+#include "telemetry.h"
 
 #include "hardware/pio.h"
 #include "hardware/clocks.h"
@@ -24,13 +27,9 @@
 
 #include "ws2812.pio.h"
 
-// LVGL Mutex - Ensures thread safety (required by LVGL official documentation)
-SemaphoreHandle_t lvgl_mutex = NULL;
-
-void vApplicationTickHook(void)
-{
-    lv_tick_inc(1);
-}
+// LVGL is only called by task1 (and by main() before the scheduler starts).
+// Other tasks post UI changes with lv_port_cmd_*(), task1 applies them before each frame.
+// LVGL reads its time from the 64-bit timer (lv_port_tick.c), no tick hook is needed.
 
 lv_obj_t *img1 = NULL;  // Startup splash image
 
@@ -272,7 +271,9 @@ static void slider_event_cb(lv_event_t *e)
     if (code == LV_EVENT_VALUE_CHANGED)
     {
         lv_color_t color = lv_colorwheel_get_rgb(obj);
-        put_pixel(urgb_u32(color.ch.red << 5, ((color.ch.green_h << 2) + color.ch.green_h) << 2, (color.ch.blue << 3)));
+        // Expand RGB565 to 8 bits per channel (independent of LV_COLOR_16_SWAP)
+        uint32_t c32 = lv_color_to32(color);
+        put_pixel(urgb_u32((c32 >> 16) & 0xFF, (c32 >> 8) & 0xFF, c32 & 0xFF));
     }
 }
 
@@ -286,33 +287,32 @@ static void clr_rgb_handler(lv_event_t *e)
     }
 }
 
-// 防抖：记录上次按键触发时间（毫秒）
-static uint32_t last_button_time_gpio14 = 0;
-static uint32_t last_button_time_gpio15 = 0;
+// 防抖：记录上次按键触发时间（中断时间戳, 微秒）
+static uint32_t last_button_us_gpio14 = 0;
+static uint32_t last_button_us_gpio15 = 0;
 #define DEBOUNCE_DELAY_MS 50  // 防抖延迟50毫秒
 
-void gpio_callback(uint gpio, uint32_t events)
+// Button events, queued by the GPIO interrupt and dispatched by task1 (LVGL context)
+static void button_handler(const button_event_t *event)
 {
-    uint32_t current_time = to_ms_since_boot(get_absolute_time());
-    
-    switch (gpio)
+    switch (event->gpio)
     {
     case 15:
         // 防抖检查：只处理上升沿，且距离上次触发超过DEBOUNCE_DELAY_MS
-        if ((events & GPIO_IRQ_EDGE_RISE) && 
-            (current_time - last_button_time_gpio15 > DEBOUNCE_DELAY_MS))
+        if ((event->events & GPIO_IRQ_EDGE_RISE) &&
+            (event->t_us - last_button_us_gpio15 > DEBOUNCE_DELAY_MS * 1000))
         {
-            last_button_time_gpio15 = current_time;
+            last_button_us_gpio15 = event->t_us;
             lv_led_toggle(led1);
             gpio_xor_mask(1ul << 16);
         }
         break;
     case 14:
         // 防抖检查：只处理上升沿，且距离上次触发超过DEBOUNCE_DELAY_MS
-        if ((events & GPIO_IRQ_EDGE_RISE) && 
-            (current_time - last_button_time_gpio14 > DEBOUNCE_DELAY_MS))
+        if ((event->events & GPIO_IRQ_EDGE_RISE) &&
+            (event->t_us - last_button_us_gpio14 > DEBOUNCE_DELAY_MS * 1000))
         {
-            last_button_time_gpio14 = current_time;
+            last_button_us_gpio14 = event->t_us;
             lv_led_toggle(led2);
             gpio_xor_mask(1ul << 17);
         }
@@ -388,9 +388,10 @@ static void hw_handler(lv_event_t *e)
         ws2812_program_init(pio, sm, offset, 12, 800000, true);
         put_pixel(urgb_u32(0, 0, 0));
 
-        gpio_set_irq_enabled_with_callback(14, GPIO_IRQ_EDGE_RISE | GPIO_IRQ_EDGE_FALL, true, &gpio_callback);
-        gpio_set_irq_enabled_with_callback(15, GPIO_IRQ_EDGE_RISE | GPIO_IRQ_EDGE_FALL, true, &gpio_callback);
-        gpio_set_irq_enabled_with_callback(22, GPIO_IRQ_EDGE_RISE | GPIO_IRQ_EDGE_FALL, true, &gpio_callback);
+        // The interrupt only queues the edge, button_handler() runs in task1
+        button_event_add(14, GPIO_IRQ_EDGE_RISE | GPIO_IRQ_EDGE_FALL);
+        button_event_add(15, GPIO_IRQ_EDGE_RISE | GPIO_IRQ_EDGE_FALL);
+        button_event_add(22, GPIO_IRQ_EDGE_RISE | GPIO_IRQ_EDGE_FALL);
 
         led1 = lv_led_create(lv_scr_act());
         lv_obj_align(led1, LV_ALIGN_TOP_MID, -30, 400);
@@ -475,22 +476,6 @@ void lv_example_btn_1(void)
 
 void task0(void *pvParam)
 {
-    // Lock mutex when initializing UI
-    xSemaphoreTake(lvgl_mutex, portMAX_DELAY);
-    lv_obj_clean(lv_scr_act());
-    xSemaphoreGive(lvgl_mutex);
-    
-    vTaskDelay(100 / portTICK_PERIOD_MS);
-
-    // Lock mutex when creating initial UI
-    xSemaphoreTake(lvgl_mutex, portMAX_DELAY);
-    img1 = lv_img_create(lv_scr_act());
-    LV_IMG_DECLARE(sea);
-    lv_img_set_src(img1, &sea);
-    lv_obj_align(img1, LV_ALIGN_DEFAULT, 0, 0);
-    lv_example_btn_1();
-    xSemaphoreGive(lvgl_mutex);
-
     for (;;)
     {
         if (adc_en)
@@ -504,7 +489,6 @@ void task0(void *pvParam)
             {
                 char buf[50];
 
-                // ADC read doesn't need mutex lock
                 adc_select_input(0);
                 uint adc_x_raw = adc_read();
                 adc_select_input(1);
@@ -518,10 +502,8 @@ void task0(void *pvParam)
                 int ball_x = (adc_x_raw * max_pos) / adc_max;
                 int ball_y = max_pos - (adc_y_raw * max_pos) / adc_max;  // Y-axis inverted
 
-                // Lock mutex when updating LVGL objects
-                xSemaphoreTake(lvgl_mutex, portMAX_DELAY);
-                lv_obj_set_pos(joystick_ball, ball_x, ball_y);
-                xSemaphoreGive(lvgl_mutex);
+                // Applied by task1 before its next frame, a pending move is replaced
+                lv_port_cmd_set_pos(joystick_ball, ball_x, ball_y);
 
                 vTaskDelay(200 / portTICK_PERIOD_MS);
             }
@@ -532,14 +514,68 @@ void task0(void *pvParam)
 
 void task1(void *pvParam)
 {
+#if LV_PORT_DISP_PERF_LOG
+    // Core 1 load: share of wall time spent inside lv_task_handler()
+    uint32_t load_start = time_us_32();
+    uint32_t load_busy = 0;
+#endif
+
     for (;;)
     {
-        // Must lock mutex before/after lv_task_handler (LVGL official requirement)
-        xSemaphoreTake(lvgl_mutex, portMAX_DELAY);
-        lv_task_handler();
-        xSemaphoreGive(lvgl_mutex);
-        
+        // Button events, commands and touch presses from other tasks first, then timers, input and rendering
+#if LV_PORT_DISP_PERF_LOG
+        uint32_t t0 = time_us_32();
+        button_event_dispatch();
+        lv_port_cmd_process();
+        lv_port_indev_process();
+        uint32_t next_ms = lv_task_handler();
+        load_busy += time_us_32() - t0;
+#else
+        button_event_dispatch();
+        lv_port_cmd_process();
+        lv_port_indev_process();
+        uint32_t next_ms = lv_task_handler();
+#endif
+
+#if TELEMETRY_ENABLE
+        // LVGL heap statistics for the telemetry report, only when one is due
+        telemetry_lvgl_sample();
+#endif
+
+#if LV_PORT_DISP_PERF_LOG
+        uint32_t elapsed = time_us_32() - load_start;
+        if (elapsed >= 1000000) {
+            lv_port_cmd_stats_t cmd_stats;
+            lv_port_cmd_get_stats(&cmd_stats, true);
+            printf("core1: %lu%% busy in lv_task_handler\n",
+                   (unsigned long)((uint64_t)load_busy * 100 / elapsed));
+            printf("cmd: %lu posted, %lu coalesced, %lu dropped, max %lu per frame, %lu wake-ups\n",
+                   (unsigned long)cmd_stats.posted,
+                   (unsigned long)cmd_stats.coalesced,
+                   (unsigned long)cmd_stats.dropped,
+                   (unsigned long)cmd_stats.max_batch,
+                   (unsigned long)cmd_stats.wakeups);
+            button_event_stats_t btn_stats;
+            button_event_get_stats(&btn_stats, true);
+            if (btn_stats.queued + btn_stats.merged + btn_stats.dropped > 0) {
+                printf("btn: %lu events, %lu bounces merged, %lu dropped, max %lu us to dispatch\n",
+                       (unsigned long)btn_stats.queued,
+                       (unsigned long)btn_stats.merged,
+                       (unsigned long)btn_stats.dropped,
+                       (unsigned long)btn_stats.max_latency_us);
+            }
+            load_busy = 0;
+            load_start = time_us_32();
+        }
+#endif
+
+#if LV_PORT_EVENT_DRIVEN
+        // Sleep until the next LVGL timer is due, or a command, button edge or touch report arrives
+        lv_port_cmd_wait(next_ms);
+#else
+        (void)next_ms;
         vTaskDelay(5 / portTICK_PERIOD_MS);
+#endif
     }
 }
 
@@ -547,18 +583,23 @@ int main()
 {
     stdio_init_all();
 
+    // Splash goes to the panel inside lv_port_disp_init(), right after sleep out
+    LV_IMG_DECLARE(sea);    // Generated from assets/sea.png at build time
+    lv_port_disp_set_boot_splash(&sea);
+
     lv_init();
     lv_port_disp_init();
     lv_port_indev_init();
+    lv_port_cmd_init();
+    button_event_init(button_handler, lv_port_cmd_wake);
 
-    // Create LVGL mutex (must be created before task startup)
-    lvgl_mutex = xSemaphoreCreateMutex();
-    if (lvgl_mutex == NULL) {
-        // Mutex creation failed, system cannot run
-        while(1) {
-            tight_loop_contents();
-        }
-    }
+    // LVGL starts with the same image, so its first frame does not change the panel
+    img1 = lv_img_create(lv_scr_act());
+    lv_img_set_src(img1, &sea);
+    lv_obj_align(img1, LV_ALIGN_DEFAULT, 0, 0);
+
+    // Initial UI on top of the splash, created before task1 runs
+    lv_example_btn_1();
 
     UBaseType_t task0_CoreAffinityMask = (1 << 0);
     UBaseType_t task1_CoreAffinityMask = (1 << 1);
@@ -572,6 +613,11 @@ int main()
     xTaskCreate(task1, "task1", 2048, NULL, 2, &task1_Handle);
     vTaskCoreAffinitySet(task1_Handle, task1_CoreAffinityMask);
 
+#if TELEMETRY_ENABLE
+    // CPU, stack and heap report every TELEMETRY_PERIOD_MS, see telemetry.c
+    telemetry_init();
+#endif
+
     vTaskStartScheduler();
 
     return 0;
@@ -12,8 +12,16 @@
 #include "st7796.h"
 #include "pico/stdlib.h"
 #include "hardware/spi.h"
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+#include "hardware/sync.h"
 #include <string.h>
 
+#if ST7796_USE_PIO
+#include "hardware/pio.h"
+#include "st7796_lcd.pio.h"
+#endif
+
 /**********************
  *      DEFINES
  **********************/
@@ -25,6 +33,18 @@
 #define LCD_RST_LOW()   gpio_put(ST7796_PIN_RST, 0)
 #define LCD_RST_HIGH()  gpio_put(ST7796_PIN_RST, 1)
 
+#if ST7796_USE_PIO
+/* st7796_lcd.pio frame headers: bit31 = DC level, bits30:0 = payload bits - 1 */
+#define PIO_HDR_CMD(bits)   ((uint32_t)(bits) - 1u)
+#define PIO_HDR_DATA(bits)  ((1u << 31) | ((uint32_t)(bits) - 1u))
+
+/* Payload words carry 16 bits in bits 31:16 */
+#define PIO_WORD(v)         ((uint32_t)(v) << 16)
+
+/* Window setup words queued ahead of the pixel payload */
+#define PIO_PROLOGUE_MAX    16
+#endif
+
 /**********************
  *      TYPEDEFS
  **********************/
@@ -44,13 +64,64 @@ static void st7796_write_cmd(uint8_t cmd);
 static void st7796_write_data(const uint8_t *data, uint16_t len);
 static void st7796_hw_reset(void);
 static void st7796_gpio_init(void);
+#if ST7796_USE_PIO
+static void st7796_pio_init(void);
+static void st7796_pio_flush_prologue(void);
+#else
 static void st7796_spi_init(void);
+static void st7796_spi_set_bits(uint8_t bits);
+#endif
+static void st7796_dma_init(void);
+static void st7796_dma_irq_handler(void);
+static void st7796_send_boot_splash(void);
+static void st7796_start_pixels(const uint16_t *src, uint32_t len, bool increment,
+                                st7796_done_cb_t cb, void *user_data);
 
 /**********************
  *  STATIC VARIABLES
  **********************/
 static st7796_orientation_t current_orientation = ST7796_PORTRAIT;
 
+/* Asynchronous transfer state */
+static int dma_chan = -1;
+static dma_channel_config dma_cfg;                  // Pixel channel config (read increment toggled for fills)
+static uint16_t fill_color;                         // Source word for st7796_fill_rect_async()
+static volatile bool dma_busy = false;
+static st7796_done_cb_t dma_done_cb = NULL;
+static void *dma_done_user_data = NULL;
+
+#if ST7796_USE_PIO
+/* PIO transmitter state */
+static uint lcd_sm;
+static int dma_ctrl_chan = -1;                      // Queues the prologue, then chains to dma_chan
+static uint32_t pio_prologue[PIO_PROLOGUE_MAX];     // Headers and payload words for the next window
+static uint8_t pio_prologue_len = 0;
+#endif
+
+/* Last window loaded into the panel's CASET/RASET registers */
+static struct {
+    bool valid;
+    uint16_t x1, y1, x2, y2;
+} win_cache = { .valid = false };
+
+/* Window command statistics. In pipeline mode the transmitter on core 0 counts them
+   while the flush callback on core 1 reads and resets them, so both take stats_lock */
+static st7796_stats_t stats = {0};
+static spin_lock_t *stats_lock;
+
+/* Image written by st7796_init() before the display is turned on */
+static struct {
+    const uint16_t *pixels;
+    st7796_line_cb_t line_cb;
+    void *user_data;
+} boot_splash = {NULL, NULL, NULL};
+static uint32_t boot_splash_us = 0;
+
+#if !ST7796_USE_PIO
+/* Current SPI frame size: 8 bits for commands, 16 bits for RAMWR pixel payloads */
+static uint8_t spi_bits = 8;
+#endif
+
 /**********************
  *   GLOBAL FUNCTIONS
  **********************/
@@ -60,11 +131,17 @@ static st7796_orientation_t current_orientation = ST7796_PORTRAIT;
  */
 void st7796_init(void)
 {
-    // 1. Initialize SPI interface
-    st7796_spi_init();
-    
-    // 2. Initialize GPIO pins
+    // 1. Initialize GPIO pins
     st7796_gpio_init();
+    stats_lock = spin_lock_init(spin_lock_claim_unused(true));
+    
+    // 2. Initialize bus (SPI0 or PIO transmitter) and TX DMA channel
+#if ST7796_USE_PIO
+    st7796_pio_init();      // Takes CS and DC over from SIO
+#else
+    st7796_spi_init();
+#endif
+    st7796_dma_init();
     
     // 3. Hardware reset
     st7796_hw_reset();
@@ -111,8 +188,7 @@ void st7796_init(void)
         // Exit sleep mode (requires 100ms delay)
         {0x11, {0}, 0x80},  // Sleep Out (bit7=1 means delay required)
         
-        // Turn on display (requires 100ms delay)
-        {0x29, {0}, 0x80},  // Display ON
+        // Display ON is sent below, once the boot splash is in GRAM
         
         // End marker
         {0, {0}, 0xFF},
@@ -138,10 +214,44 @@ void st7796_init(void)
     }
     
     // 6. Set default display orientation
+    // (also invalidates the window cache, the sequence above wrote CASET/RASET)
     st7796_set_orientation(ST7796_PORTRAIT);
     
     // 7. Enable color inversion (may be needed depending on screen characteristics)
     st7796_write_cmd(0x21);  // Display Inversion ON
+    
+    // 8. Boot splash into GRAM while the display is still off, so the first frame
+    //    the panel shows is the image and not leftover GRAM content
+    st7796_send_boot_splash();
+    
+    // 9. Turn on display (requires 100ms delay)
+    st7796_write_cmd(ST7796_CMD_DISPON);
+    if (boot_splash.pixels != NULL || boot_splash.line_cb != NULL) {
+        boot_splash_us = time_us_32();
+    }
+    sleep_ms(100);
+}
+
+/**
+ * @brief Set the image st7796_init() writes into the panel before it turns the display on
+ * @param pixels Full portrait screen of native RGB565 pixels, NULL to use line_cb
+ * @param line_cb Row callback when pixels is NULL, NULL for no splash
+ * @param user_data Argument passed to line_cb
+ */
+void st7796_set_boot_splash(const uint16_t *pixels, st7796_line_cb_t line_cb, void *user_data)
+{
+    boot_splash.pixels = pixels;
+    boot_splash.line_cb = line_cb;
+    boot_splash.user_data = user_data;
+}
+
+/**
+ * @brief Get the time at which the boot splash was on the panel
+ * @return Microseconds since boot, 0 if no boot splash was set
+ */
+uint32_t st7796_get_boot_splash_us(void)
+{
+    return boot_splash_us;
 }
 
 /**
@@ -152,6 +262,11 @@ void st7796_set_orientation(st7796_orientation_t orientation)
 {
     current_orientation = orientation;
     
+    st7796_wait_idle();
+    
+    // Address mapping changes, force CASET/RASET on the next window
+    win_cache.valid = false;
+    
     st7796_write_cmd(ST7796_CMD_MADCTL);  // 0x36
     
     uint8_t madctl_value;
@@ -183,10 +298,16 @@ void st7796_set_orientation(st7796_orientation_t orientation)
             break;
     }
     
-    LCD_CS_LOW();
-    LCD_DC_DATA();
-    spi_write_blocking(ST7796_SPI_PORT, &madctl_value, 1);
-    LCD_CS_HIGH();
+    st7796_write_data(&madctl_value, 1);
+}
+
+/**
+ * @brief Get display orientation
+ * @return Orientation set by st7796_set_orientation()
+ */
+st7796_orientation_t st7796_get_orientation(void)
+{
+    return current_orientation;
 }
 
 /**
@@ -198,31 +319,115 @@ void st7796_set_orientation(st7796_orientation_t orientation)
  */
 void st7796_set_window(uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2)
 {
+    // Address commands whose range is already loaded in the panel are skipped.
+    // Full-width LVGL strips only change rows, so CASET is normally dropped.
+    st7796_wait_idle();
+    
+    bool send_col = !win_cache.valid || win_cache.x1 != x1 || win_cache.x2 != x2;
+    bool send_row = !win_cache.valid || win_cache.y1 != y1 || win_cache.y2 != y2;
+    
+    win_cache.x1 = x1;
+    win_cache.x2 = x2;
+    win_cache.y1 = y1;
+    win_cache.y2 = y2;
+    win_cache.valid = true;
+    
+    // Command byte + 4 parameter bytes per address command
+    uint32_t saved = (send_col ? 0 : 5) + (send_row ? 0 : 5);
+    uint32_t save = spin_lock_blocking(stats_lock);
+    stats.cmd_bytes_saved += saved;
+    stats.cmd_bytes_sent += 11 - saved;   // CASET + RASET + RAMWR = 11 bytes
+    spin_unlock(stats_lock, save);
+    
+#if ST7796_USE_PIO
+    // Stage the commands, they are queued together with the pixel payload
+    // by st7796_write_color_async() so the whole flush is a single DMA chain
+    uint8_t n = 0;
+    if (send_col) {
+        pio_prologue[n++] = PIO_HDR_CMD(8);
+        pio_prologue[n++] = PIO_WORD(ST7796_CMD_CASET << 8);
+        pio_prologue[n++] = PIO_HDR_DATA(32);
+        pio_prologue[n++] = PIO_WORD(x1);
+        pio_prologue[n++] = PIO_WORD(x2);
+    }
+    if (send_row) {
+        pio_prologue[n++] = PIO_HDR_CMD(8);
+        pio_prologue[n++] = PIO_WORD(ST7796_CMD_RASET << 8);
+        pio_prologue[n++] = PIO_HDR_DATA(32);
+        pio_prologue[n++] = PIO_WORD(y1);
+        pio_prologue[n++] = PIO_WORD(y2);
+    }
+    pio_prologue[n++] = PIO_HDR_CMD(8);
+    pio_prologue[n++] = PIO_WORD(ST7796_CMD_RAMWR << 8);
+    pio_prologue_len = n;
+#else
+    uint8_t cmd;
     uint8_t data[4];
     
-    // Set column address range (X coordinate)
-    st7796_write_cmd(ST7796_CMD_CASET);  // 0x2A
-    data[0] = (x1 >> 8) & 0xFF;  // Start X high byte
-    data[1] = x1 & 0xFF;         // Start X low byte
-    data[2] = (x2 >> 8) & 0xFF;  // End X high byte
-    data[3] = x2 & 0xFF;         // End X low byte
-    st7796_write_data(data, 4);
-    
-    // Set row address range (Y coordinate)
-    st7796_write_cmd(ST7796_CMD_RASET);  // 0x2B
-    data[0] = (y1 >> 8) & 0xFF;  // Start Y high byte
-    data[1] = y1 & 0xFF;         // Start Y low byte
-    data[2] = (y2 >> 8) & 0xFF;  // End Y high byte
-    data[3] = y2 & 0xFF;         // End Y low byte
-    st7796_write_data(data, 4);
+    // All address commands go out under one CS assertion, only DC toggles.
+    // spi_write_blocking() returns after the shifter is idle, so DC can change
+    // right away without extra delays.
+    st7796_spi_set_bits(8);
+    LCD_CS_LOW();
+    
+    if (send_col) {
+        // Set column address range (X coordinate)
+        cmd = ST7796_CMD_CASET;      // 0x2A
+        data[0] = (x1 >> 8) & 0xFF;  // Start X high byte
+        data[1] = x1 & 0xFF;         // Start X low byte
+        data[2] = (x2 >> 8) & 0xFF;  // End X high byte
+        data[3] = x2 & 0xFF;         // End X low byte
+        LCD_DC_CMD();
+        spi_write_blocking(ST7796_SPI_PORT, &cmd, 1);
+        LCD_DC_DATA();
+        spi_write_blocking(ST7796_SPI_PORT, data, 4);
+    }
+    
+    if (send_row) {
+        // Set row address range (Y coordinate)
+        cmd = ST7796_CMD_RASET;      // 0x2B
+        data[0] = (y1 >> 8) & 0xFF;  // Start Y high byte
+        data[1] = y1 & 0xFF;         // Start Y low byte
+        data[2] = (y2 >> 8) & 0xFF;  // End Y high byte
+        data[3] = y2 & 0xFF;         // End Y low byte
+        LCD_DC_CMD();
+        spi_write_blocking(ST7796_SPI_PORT, &cmd, 1);
+        LCD_DC_DATA();
+        spi_write_blocking(ST7796_SPI_PORT, data, 4);
+    }
     
     // Prepare to write GRAM
-    st7796_write_cmd(ST7796_CMD_RAMWR);  // 0x2C
+    cmd = ST7796_CMD_RAMWR;          // 0x2C
+    LCD_DC_CMD();
+    spi_write_blocking(ST7796_SPI_PORT, &cmd, 1);
+    LCD_DC_DATA();
+    
+    LCD_CS_HIGH();
+#endif
+}
+
+/**
+ * @brief Read window command statistics
+ * @param out Output parameter: counters since the last reset
+ * @param reset Clear the counters after reading (e.g. once per frame)
+ */
+void st7796_get_stats(st7796_stats_t *out, bool reset)
+{
+    // Read and reset in one step, the transmitter may count on the other core
+    uint32_t save = spin_lock_blocking(stats_lock);
+    if (out != NULL) {
+        *out = stats;
+    }
+    if (reset) {
+        stats.cmd_bytes_sent = 0;
+        stats.cmd_bytes_saved = 0;
+    }
+    spin_unlock(stats_lock, save);
 }
 
 /**
  * @brief Write color data to display area
- * @param color Color data pointer (RGB565 format, 2 bytes per pixel)
+ * @param color Color data pointer (native RGB565 values, one uint16_t per pixel)
  * @param len Number of pixels
  * @note Must call st7796_set_window() to set display area before calling this function
  */
@@ -232,26 +437,206 @@ void st7796_write_color(const uint16_t *color, uint32_t len)
         return;
     }
     
+#if ST7796_USE_PIO
+    // The PIO path is DMA only, start it and wait
+    st7796_write_color_async(color, len, NULL, NULL);
+    st7796_wait_idle();
+#else
+    st7796_wait_idle();
+    
+    // 16-bit frames send each pixel MSB first, no byte swapping needed
+    st7796_spi_set_bits(16);
+    
     LCD_CS_LOW();
     LCD_DC_DATA();
     
     // Write color data
-    // RGB565 format: 2 bytes per pixel
-    spi_write_blocking(ST7796_SPI_PORT, (const uint8_t *)color, len * 2);
+    spi_write16_blocking(ST7796_SPI_PORT, color, len);
     
     LCD_CS_HIGH();
+#endif
+}
+
+/**
+ * @brief Start non-blocking write of color data to display area
+ * @param color Color data pointer (native RGB565 values, one uint16_t per pixel)
+ * @param len Number of pixels
+ * @param cb Completion callback, called from DMA IRQ after CS is raised
+ * @param user_data Argument passed to cb
+ * @note The DMA channel is paced by the SPI (or PIO) TX DREQ, so the CPU is free while pixels are sent
+ */
+void st7796_write_color_async(const uint16_t *color, uint32_t len,
+                              st7796_done_cb_t cb, void *user_data)
+{
+    if (len == 0 || color == NULL) {
+        if (cb != NULL) {
+            cb(user_data);
+        }
+        return;
+    }
+    
+    st7796_start_pixels(color, len, true, cb, user_data);
+}
+
+/**
+ * @brief Start non-blocking solid fill of a rectangle
+ * @param x1 Start X coordinate
+ * @param y1 Start Y coordinate
+ * @param x2 End X coordinate
+ * @param y2 End Y coordinate
+ * @param color Native RGB565 fill color
+ * @param cb Completion callback, called from DMA IRQ, may be NULL
+ * @param user_data Argument passed to cb
+ * @note DMA streams the same color word with a non-incrementing read address,
+ *       no pixel buffer is involved
+ */
+void st7796_fill_rect_async(uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2, uint16_t color,
+                            st7796_done_cb_t cb, void *user_data)
+{
+    if (x2 < x1 || y2 < y1) {
+        if (cb != NULL) {
+            cb(user_data);
+        }
+        return;
+    }
+    
+    uint32_t len = (uint32_t)(x2 - x1 + 1) * (y2 - y1 + 1);
+    
+    st7796_set_window(x1, y1, x2, y2);  // Also waits for the previous transfer
+    fill_color = color;
+    st7796_start_pixels(&fill_color, len, false, cb, user_data);
+}
+
+/**
+ * @brief Fill a rectangle with a solid color
+ * @param x1 Start X coordinate
+ * @param y1 Start Y coordinate
+ * @param x2 End X coordinate
+ * @param y2 End Y coordinate
+ * @param color Native RGB565 fill color
+ */
+void st7796_fill_rect(uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2, uint16_t color)
+{
+    st7796_fill_rect_async(x1, y1, x2, y2, color, NULL, NULL);
+    st7796_wait_idle();
+}
+
+/**
+ * @brief Check whether an asynchronous transfer is still running
+ * @return true while DMA is feeding the display
+ */
+bool st7796_is_busy(void)
+{
+    return dma_busy;
+}
+
+/**
+ * @brief Wait until the running asynchronous transfer (if any) has finished
+ */
+void st7796_wait_idle(void)
+{
+    while (dma_busy) {
+        tight_loop_contents();
+    }
 }
 
 /**********************
  *   STATIC FUNCTIONS
  **********************/
 
+/**
+ * @brief Start DMA of a pixel payload into the current window
+ * @param src Pixel source
+ * @param len Number of pixels
+ * @param increment true: stream a buffer, false: repeat *src (solid fill)
+ * @param cb Completion callback, called from DMA IRQ
+ * @param user_data Argument passed to cb
+ */
+static void st7796_start_pixels(const uint16_t *src, uint32_t len, bool increment,
+                                st7796_done_cb_t cb, void *user_data)
+{
+    // Only one transfer can own the bus at a time
+    st7796_wait_idle();
+    
+    dma_done_cb = cb;
+    dma_done_user_data = user_data;
+    dma_busy = true;
+    
+    channel_config_set_read_increment(&dma_cfg, increment);
+    dma_channel_set_config(dma_chan, &dma_cfg, false);
+    
+#if ST7796_USE_PIO
+    // Window setup (if staged) + pixel header go out first, then the control
+    // channel chains to the pixel channel. CS/DC are framed by the PIO program.
+    pio_prologue[pio_prologue_len++] = PIO_HDR_DATA(len * 16);
+    
+    dma_channel_set_read_addr(dma_chan, src, false);
+    dma_channel_set_trans_count(dma_chan, len, false);
+    
+    dma_channel_set_read_addr(dma_ctrl_chan, pio_prologue, false);
+    dma_channel_set_trans_count(dma_ctrl_chan, pio_prologue_len, true);
+    pio_prologue_len = 0;
+#else
+    st7796_spi_set_bits(16);
+    
+    LCD_CS_LOW();
+    LCD_DC_DATA();
+    
+    // One 16-bit SPI frame per pixel, CS is released by st7796_dma_irq_handler()
+    dma_channel_transfer_from_buffer_now(dma_chan, src, len);
+#endif
+}
+
+/**
+ * @brief Write the boot splash into GRAM (portrait, full screen)
+ * @note Runs before the scheduler, on the caller's stack. Rows from line_cb are
+ *       produced into one buffer while DMA sends the other
+ */
+static void st7796_send_boot_splash(void)
+{
+    if (boot_splash.pixels != NULL) {
+        // Image already in panel format: one DMA transfer straight from flash
+        st7796_set_window(0, 0, ST7796_WIDTH - 1, ST7796_HEIGHT - 1);
+        st7796_write_color_async(boot_splash.pixels, (uint32_t)ST7796_WIDTH * ST7796_HEIGHT, NULL, NULL);
+        st7796_wait_idle();
+        return;
+    }
+    
+    if (boot_splash.line_cb == NULL) {
+        return;
+    }
+    
+    uint16_t line[2][ST7796_WIDTH];
+    
+    boot_splash.line_cb(0, line[0], boot_splash.user_data);
+    for (uint16_t y = 0; y < ST7796_HEIGHT; y++) {
+        // Waits for row y - 1, whose buffer is refilled below
+        st7796_set_window(0, y, ST7796_WIDTH - 1, y);
+        st7796_write_color_async(line[y & 1], ST7796_WIDTH, NULL, NULL);
+        
+        if (y + 1 < ST7796_HEIGHT) {
+            boot_splash.line_cb(y + 1, line[(y + 1) & 1], boot_splash.user_data);
+        }
+    }
+    st7796_wait_idle();
+}
+
 /**
  * @brief Send command to ST7796
  * @param cmd Command byte
  */
 static void st7796_write_cmd(uint8_t cmd)
 {
+    st7796_wait_idle();
+    
+#if ST7796_USE_PIO
+    st7796_pio_flush_prologue();
+    
+    pio_sm_put_blocking(ST7796_PIO, lcd_sm, PIO_HDR_CMD(8));
+    pio_sm_put_blocking(ST7796_PIO, lcd_sm, PIO_WORD(cmd << 8));
+#else
+    st7796_spi_set_bits(8);
+    
     LCD_CS_LOW();
     LCD_DC_CMD();       // DC=0 means sending command
     sleep_us(1);        // Brief delay to ensure signal stability
@@ -260,6 +645,7 @@ static void st7796_write_cmd(uint8_t cmd)
     
     sleep_us(1);
     LCD_CS_HIGH();
+#endif
 }
 
 /**
@@ -273,6 +659,23 @@ static void st7796_write_data(const uint8_t *data, uint16_t len)
         return;
     }
     
+    st7796_wait_idle();
+    
+#if ST7796_USE_PIO
+    st7796_pio_flush_prologue();
+    
+    // Two bytes per payload word, a trailing odd byte is padded and not clocked out
+    pio_sm_put_blocking(ST7796_PIO, lcd_sm, PIO_HDR_DATA(len * 8));
+    for (uint16_t i = 0; i < len; i += 2) {
+        uint16_t word = (uint16_t)data[i] << 8;
+        if (i + 1 < len) {
+            word |= data[i + 1];
+        }
+        pio_sm_put_blocking(ST7796_PIO, lcd_sm, PIO_WORD(word));
+    }
+#else
+    st7796_spi_set_bits(8);
+    
     LCD_CS_LOW();
     LCD_DC_DATA();      // DC=1 means sending data
     sleep_us(1);
@@ -281,6 +684,7 @@ static void st7796_write_data(const uint8_t *data, uint16_t len)
     
     sleep_us(1);
     LCD_CS_HIGH();
+#endif
 }
 
 /**
@@ -320,6 +724,31 @@ static void st7796_gpio_init(void)
     gpio_put(ST7796_PIN_RST, 1);  // Default high (no reset)
 }
 
+#if ST7796_USE_PIO
+/**
+ * @brief Initialize PIO transmitter
+ * @note CLK/MOSI/CS/DC are driven by the state machine, RST stays on SIO
+ */
+static void st7796_pio_init(void)
+{
+    uint offset = pio_add_program(ST7796_PIO, &st7796_lcd_program);
+    lcd_sm = pio_claim_unused_sm(ST7796_PIO, true);
+    
+    st7796_lcd_program_init(ST7796_PIO, lcd_sm, offset, ST7796_PIN_CLK,
+                            ST7796_PIN_MOSI, ST7796_PIN_CS, ST7796_PIO_CLKDIV);
+}
+
+/**
+ * @brief Send a staged window setup that was not followed by pixel data
+ */
+static void st7796_pio_flush_prologue(void)
+{
+    for (uint8_t i = 0; i < pio_prologue_len; i++) {
+        pio_sm_put_blocking(ST7796_PIO, lcd_sm, pio_prologue[i]);
+    }
+    pio_prologue_len = 0;
+}
+#else
 /**
  * @brief Initialize SPI interface
  */
@@ -337,3 +766,107 @@ static void st7796_spi_init(void)
     gpio_set_function(ST7796_PIN_CLK, GPIO_FUNC_SPI);   // CLK (clock)
 }
 
+/**
+ * @brief Switch SPI frame size
+ * @param bits 8 for commands/parameters, 16 for RAMWR pixel payloads
+ * @note Bus must be idle (callers wait for DMA, spi_write_blocking waits for the shifter)
+ */
+static void st7796_spi_set_bits(uint8_t bits)
+{
+    if (spi_bits == bits) {
+        return;
+    }
+    
+    spi_set_format(ST7796_SPI_PORT, bits, SPI_CPOL_0, SPI_CPHA_0, SPI_MSB_FIRST);
+    spi_bits = bits;
+}
+#endif
+
+/**
+ * @brief Initialize DMA channel for asynchronous pixel transfers
+ * @note SPI: channel writes pixels to the SPI data register, paced by the SPI TX DREQ.
+ *       PIO: a control channel queues the prologue words and chains to the pixel channel.
+ */
+static void st7796_dma_init(void)
+{
+    dma_chan = dma_claim_unused_channel(true);
+    
+#if ST7796_USE_PIO
+    uint dreq = pio_get_dreq(ST7796_PIO, lcd_sm, true);
+    volatile void *txf = &ST7796_PIO->txf[lcd_sm];
+    
+    // Pixel channel: one RGB565 pixel per FIFO word (16-bit writes are replicated
+    // into bits 31:16), shifted out MSB first
+    dma_channel_config c = dma_channel_get_default_config(dma_chan);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_16);
+    channel_config_set_read_increment(&c, true);
+    channel_config_set_write_increment(&c, false);
+    channel_config_set_dreq(&c, dreq);
+    dma_channel_configure(dma_chan, &c, txf, NULL, 0, false);
+    dma_cfg = c;
+    
+    // Control channel: prologue words, then trigger the pixel channel
+    dma_ctrl_chan = dma_claim_unused_channel(true);
+    dma_channel_config cc = dma_channel_get_default_config(dma_ctrl_chan);
+    channel_config_set_transfer_data_size(&cc, DMA_SIZE_32);
+    channel_config_set_read_increment(&cc, true);
+    channel_config_set_write_increment(&cc, false);
+    channel_config_set_dreq(&cc, dreq);
+    channel_config_set_chain_to(&cc, dma_chan);
+    dma_channel_configure(dma_ctrl_chan, &cc, txf, pio_prologue, 0, false);
+#else
+    dma_channel_config c = dma_channel_get_default_config(dma_chan);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_16); // Pixels go out as 16-bit SPI frames
+    channel_config_set_read_increment(&c, true);
+    channel_config_set_write_increment(&c, false);
+    channel_config_set_dreq(&c, spi_get_dreq(ST7796_SPI_PORT, true));
+    
+    dma_channel_configure(dma_chan, &c,
+                          &spi_get_hw(ST7796_SPI_PORT)->dr,  // Write address (fixed)
+                          NULL,                               // Read address (set per transfer)
+                          0,
+                          false);                             // Don't start yet
+    dma_cfg = c;
+#endif
+    
+    // Shared handler so other drivers can use the same DMA IRQ line
+    dma_irqn_set_channel_enabled(ST7796_DMA_IRQ - DMA_IRQ_0, dma_chan, true);
+    irq_add_shared_handler(ST7796_DMA_IRQ, st7796_dma_irq_handler,
+                           PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+    irq_set_enabled(ST7796_DMA_IRQ, true);
+}
+
+/**
+ * @brief DMA completion interrupt handler
+ * @note DMA is done once the last byte is in the TX FIFO, so wait for the
+ *       SPI shifter to drain before raising CS. With the PIO transmitter CS
+ *       is released by the state machine itself.
+ */
+static void st7796_dma_irq_handler(void)
+{
+    uint irq_index = ST7796_DMA_IRQ - DMA_IRQ_0;
+    
+    if (dma_chan < 0 || !dma_irqn_get_channel_status(irq_index, dma_chan)) {
+        return;  // Not our channel
+    }
+    dma_irqn_acknowledge_channel(irq_index, dma_chan);
+    
+#if !ST7796_USE_PIO
+    while (spi_is_busy(ST7796_SPI_PORT)) {
+        tight_loop_contents();
+    }
+    LCD_CS_HIGH();
+    
+    // Discard data clocked in during the transfer and clear the overrun flag
+    while (spi_is_readable(ST7796_SPI_PORT)) {
+        (void)spi_get_hw(ST7796_SPI_PORT)->dr;
+    }
+    spi_get_hw(ST7796_SPI_PORT)->icr = SPI_SSPICR_RORIC_BITS;
+#endif
+    
+    dma_busy = false;
+    
+    if (dma_done_cb != NULL) {
+        dma_done_cb(dma_done_user_data);
+    }
+}
\ No newline at end of file
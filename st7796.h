@@ -44,9 +44,42 @@
 #define ST7796_CMD_MADCTL       0x36  // Memory Access Control
 #define ST7796_CMD_COLMOD       0x3A  // Pixel Format Set
 
+/* Bus transport: 0 = SPI0 peripheral with GPIO CS/DC, 1 = PIO program (st7796_lcd.pio)
+ * that frames CS/DC in-band. Set from CMake with -DST7796_USE_PIO=ON */
+#ifndef ST7796_USE_PIO
+#define ST7796_USE_PIO      0
+#endif
+
+/* PIO transport configuration (CS and DC must be consecutive GPIOs) */
+#define ST7796_PIO          pio1        // pio0 is used by the WS2812 driver
+#define ST7796_PIO_CLKDIV   1.0f        // 3 PIO cycles per bit: 41.6MHz at 125MHz clk_sys
+
+/* DMA interrupt line used for asynchronous transfers */
+#define ST7796_DMA_IRQ      DMA_IRQ_0
+
 /**********************
  *      TYPEDEFS
  **********************/
+/**
+ * @brief Transfer complete callback
+ * @note Called from DMA interrupt context after CS has been released
+ */
+typedef void (*st7796_done_cb_t)(void *user_data);
+
+/**
+ * @brief Boot splash row callback: write row y (ST7796_WIDTH native RGB565 pixels) into line
+ * @note Called from st7796_init() while the previous row is being sent
+ */
+typedef void (*st7796_line_cb_t)(uint16_t y, uint16_t *line, void *user_data);
+
+/**
+ * @brief Window command statistics
+ */
+typedef struct {
+    uint32_t cmd_bytes_sent;    // CASET/RASET/RAMWR bytes sent
+    uint32_t cmd_bytes_saved;   // Bytes skipped because the window was already loaded
+} st7796_stats_t;
+
 /* Screen Orientation Definitions */
 typedef enum {
     ST7796_PORTRAIT         = 0,  // Portrait mode
@@ -64,14 +97,37 @@ typedef enum {
  */
 void st7796_init(void);
 
+/**
+ * @brief Set the image st7796_init() writes into the panel before it turns the display on
+ * @param pixels Full portrait screen of native RGB565 pixels (e.g. in flash), NULL to use line_cb
+ * @param line_cb Row callback when pixels is NULL (e.g. to decompress), NULL for no splash
+ * @param user_data Argument passed to line_cb
+ * @note Call before st7796_init(). The first thing the panel shows is then the image,
+ *       well before the application (or a GUI library) draws its first frame
+ */
+void st7796_set_boot_splash(const uint16_t *pixels, st7796_line_cb_t line_cb, void *user_data);
+
+/**
+ * @brief Get the time at which the boot splash was on the panel
+ * @return Microseconds since boot when the display was turned on showing it, 0 if none
+ */
+uint32_t st7796_get_boot_splash_us(void);
+
 /**
  * @brief Set display orientation
  * @param orientation Screen orientation
  */
 void st7796_set_orientation(st7796_orientation_t orientation);
 
+/**
+ * @brief Get display orientation
+ * @return Orientation set by st7796_set_orientation()
+ */
+st7796_orientation_t st7796_get_orientation(void);
+
 /**
  * @brief Set display window (drawing area)
+ * @note Address commands for a range already loaded in the panel are skipped
  * @param x1 Start X coordinate
  * @param y1 Start Y coordinate
  * @param x2 End X coordinate
@@ -79,11 +135,64 @@ void st7796_set_orientation(st7796_orientation_t orientation);
  */
 void st7796_set_window(uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2);
 
+/**
+ * @brief Read window command statistics
+ * @param out Output parameter: counters since the last reset
+ * @param reset Clear the counters after reading
+ */
+void st7796_get_stats(st7796_stats_t *out, bool reset);
+
 /**
  * @brief Write color data to display area
- * @param color Color data pointer (RGB565 format)
+ * @param color Color data pointer (native RGB565 values, sent as 16-bit SPI frames)
  * @param len Number of pixels
  */
 void st7796_write_color(const uint16_t *color, uint32_t len);
 
+/**
+ * @brief Start non-blocking write of color data to display area
+ * @param color Color data pointer (native RGB565 values), must stay valid until cb runs
+ * @param len Number of pixels
+ * @param cb Completion callback (DMA IRQ context), may be NULL
+ * @param user_data Argument passed to cb
+ * @note Must call st7796_set_window() first. Returns as soon as the DMA channel is started.
+ */
+void st7796_write_color_async(const uint16_t *color, uint32_t len,
+                              st7796_done_cb_t cb, void *user_data);
+
+/**
+ * @brief Fill a rectangle with a solid color (blocking)
+ * @param x1 Start X coordinate
+ * @param y1 Start Y coordinate
+ * @param x2 End X coordinate
+ * @param y2 End Y coordinate
+ * @param color Native RGB565 fill color
+ */
+void st7796_fill_rect(uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2, uint16_t color);
+
+/**
+ * @brief Start non-blocking solid fill of a rectangle
+ * @param x1 Start X coordinate
+ * @param y1 Start Y coordinate
+ * @param x2 End X coordinate
+ * @param y2 End Y coordinate
+ * @param color Native RGB565 fill color
+ * @param cb Completion callback (DMA IRQ context), may be NULL
+ * @param user_data Argument passed to cb
+ * @note Streams one color word with a non-incrementing DMA read address
+ */
+void st7796_fill_rect_async(uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2, uint16_t color,
+                            st7796_done_cb_t cb, void *user_data);
+
+/**
+ * @brief Check whether an asynchronous transfer is still running
+ * @return true while DMA is feeding the display
+ */
+bool st7796_is_busy(void);
+
+/**
+ * @brief Wait until the running asynchronous transfer (if any) has finished
+ */
+void st7796_wait_idle(void);
+
 #endif /* ST7796_H */
\ No newline at end of file
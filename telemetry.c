@@ -0,0 +1,319 @@
+/**
+ * @file telemetry.c
+ * @brief Run-time telemetry: CPU load per core and per task, stack high-water marks,
+ *        FreeRTOS heap and LVGL memory, printed periodically over stdio
+ * @note Task CPU time comes from the FreeRTOS run time stats, counted in microseconds of the
+ *       RP2040 timer. Core load is the time a core does not spend in an idle task, accounted
+ *       by the context switch hook, so a core asleep in tickless idle counts as idle
+ * @author NIGHT
+ * @date 2025-10-27
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "telemetry.h"
+
+#if TELEMETRY_ENABLE
+
+#include <stdio.h>
+#include <string.h>
+#include "pico/stdlib.h"
+#include "hardware/sync.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "lvgl.h"
+#include "lv_port_cmd.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define TELEMETRY_TASK_PRIO         1
+#define TELEMETRY_CORES             configNUM_CORES
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct {
+    TaskHandle_t handle;
+    uint32_t run_time_us;       // Run time counter at the previous report
+} task_prev_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void telemetry_task(void *param);
+static uint32_t take_snapshot(void);
+static void find_idle_tasks(uint32_t n);
+static uint32_t core_idle_us(uint32_t core, uint32_t now);
+static uint32_t permille(uint32_t part, uint32_t whole);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+/* Context switch hook state, each core writes its own entry */
+static TaskHandle_t idle_tasks[TELEMETRY_CORES];
+static volatile bool core_in_idle[TELEMETRY_CORES];
+static volatile uint32_t core_switch_us[TELEMETRY_CORES];   // Last switch on this core
+static volatile uint32_t core_idle_total_us[TELEMETRY_CORES];
+
+/* Telemetry task only */
+static TaskStatus_t task_status[TELEMETRY_MAX_TASKS];
+static task_prev_t task_prev[TELEMETRY_MAX_TASKS];
+static uint32_t task_prev_count = 0;
+
+/* LVGL memory sample, written by the LVGL task under mem_lock */
+static spin_lock_t *mem_lock;
+static volatile bool mem_sample_request = false;
+static bool mem_sample_valid = false;
+static lv_mem_monitor_t mem_sample;
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+/**
+ * @brief Create the telemetry task (core 0, lowest priority)
+ */
+void telemetry_init(void)
+{
+    mem_lock = spin_lock_init(spin_lock_claim_unused(true));
+
+    TaskHandle_t handle = NULL;
+    if (xTaskCreate(telemetry_task, "telemetry", 512, NULL, TELEMETRY_TASK_PRIO, &handle) != pdPASS) {
+        return;
+    }
+    vTaskCoreAffinitySet(handle, (1 << 0));
+}
+
+/**
+ * @brief Take the LVGL memory sample for the next report (LVGL task)
+ */
+void telemetry_lvgl_sample(void)
+{
+    if (!mem_sample_request) {
+        return;
+    }
+
+    lv_mem_monitor_t mon;
+    lv_mem_monitor(&mon);
+
+    uint32_t save = spin_lock_blocking(mem_lock);
+    mem_sample = mon;
+    mem_sample_valid = true;
+    spin_unlock(mem_lock, save);
+    mem_sample_request = false;
+}
+
+/**
+ * @brief Microsecond timer as FreeRTOS run time counter (portGET_RUN_TIME_COUNTER_VALUE)
+ * @return time_us_32(), wraps after 71 minutes, report periods are much shorter
+ */
+uint32_t telemetry_run_time_us(void)
+{
+    return time_us_32();
+}
+
+/**
+ * @brief Context switch hook (traceTASK_SWITCHED_IN), accounts idle time per core
+ * @note No kernel calls other than reading the current task, the scheduler is locked
+ */
+void telemetry_task_switched_in(void)
+{
+    uint32_t core = get_core_num();
+    uint32_t now = time_us_32();
+
+    if (core_in_idle[core]) {
+        core_idle_total_us[core] += now - core_switch_us[core];
+    }
+    core_switch_us[core] = now;
+
+    TaskHandle_t task = xTaskGetCurrentTaskHandle();
+    bool idle = false;
+    for (uint32_t i = 0; i < TELEMETRY_CORES; i++) {
+        if (idle_tasks[i] != NULL && idle_tasks[i] == task) {
+            idle = true;
+        }
+    }
+    core_in_idle[core] = idle;
+}
+
+/**
+ * @brief Stack overflow hook (configCHECK_FOR_STACK_OVERFLOW)
+ * @param task Task whose stack overflowed
+ * @param name Its name
+ * @note The stack is already corrupt, stop with the task name instead of running on
+ */
+void vApplicationStackOverflowHook(TaskHandle_t task, char *name)
+{
+    (void)task;
+    panic("stack overflow in task %s", name);
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+/**
+ * @brief Telemetry task: one report per TELEMETRY_PERIOD_MS
+ * @param param Unused
+ * @note Report lines (one "tm sys" line, then one "tm task" line per task):
+ *       tm sys t=<s> cpu0=<%> cpu1=<%> heap_free=<B> heap_min=<B> lv_total=<B> lv_free=<B>
+ *              lv_big=<B> lv_max_used=<B> lv_frag=<%>
+ *       tm task name=<name> prio=<n> aff=<core mask> cpu=<% of one core> stack_free=<B>
+ *       stack_free is the least free stack the task ever had (high-water mark)
+ */
+static void telemetry_task(void *param)
+{
+    (void)param;
+
+    // 1. Idle tasks exist once the scheduler runs, start counting from here
+    uint32_t n = take_snapshot();
+    find_idle_tasks(n);
+
+    uint32_t last_us = time_us_32();
+    uint32_t last_idle[TELEMETRY_CORES];
+    for (uint32_t c = 0; c < TELEMETRY_CORES; c++) {
+        last_idle[c] = core_idle_us(c, last_us);
+    }
+
+    for (;;) {
+        // 2. LVGL heap is sampled by the LVGL task during this period
+        mem_sample_request = true;
+        lv_port_cmd_wake();
+
+        vTaskDelay(pdMS_TO_TICKS(TELEMETRY_PERIOD_MS));
+
+        uint32_t now = time_us_32();
+        uint32_t elapsed = now - last_us;
+        last_us = now;
+
+        // 3. System line: core load, FreeRTOS heap (heap_4), LVGL heap. Built first and
+        //    printed in one call, so perf lines of other tasks do not split it
+        char line[192];
+        int len = snprintf(line, sizeof(line), "tm sys t=%lu", (unsigned long)(time_us_64() / 1000000));
+        for (uint32_t c = 0; c < TELEMETRY_CORES; c++) {
+            uint32_t idle = core_idle_us(c, now);
+            uint32_t idle_delta = idle - last_idle[c];
+            last_idle[c] = idle;
+            uint32_t pm = permille(idle_delta < elapsed ? elapsed - idle_delta : 0, elapsed);
+            len += snprintf(line + len, sizeof(line) - len, " cpu%lu=%lu.%lu",
+                            (unsigned long)c, (unsigned long)(pm / 10), (unsigned long)(pm % 10));
+        }
+        len += snprintf(line + len, sizeof(line) - len, " heap_free=%lu heap_min=%lu",
+                        (unsigned long)xPortGetFreeHeapSize(),
+                        (unsigned long)xPortGetMinimumEverFreeHeapSize());
+
+        lv_mem_monitor_t mon;
+        uint32_t save = spin_lock_blocking(mem_lock);
+        bool mem_valid = mem_sample_valid;
+        mon = mem_sample;
+        spin_unlock(mem_lock, save);
+        if (mem_valid) {
+            snprintf(line + len, sizeof(line) - len,
+                     " lv_total=%lu lv_free=%lu lv_big=%lu lv_max_used=%lu lv_frag=%u",
+                     (unsigned long)mon.total_size,
+                     (unsigned long)mon.free_size,
+                     (unsigned long)mon.free_biggest_size,
+                     (unsigned long)mon.max_used,
+                     (unsigned)mon.frag_pct);
+        }
+        printf("%s\n", line);
+
+        // 4. One line per task, CPU time since the last report
+        task_prev_t prev[TELEMETRY_MAX_TASKS];
+        uint32_t prev_count = task_prev_count;
+        memcpy(prev, task_prev, prev_count * sizeof(task_prev_t));
+
+        n = take_snapshot();
+        if (n == 0) {
+            printf("tm err tasks=%lu max=%u\n",
+                   (unsigned long)uxTaskGetNumberOfTasks(), (unsigned)TELEMETRY_MAX_TASKS);
+            continue;
+        }
+
+        for (uint32_t i = 0; i < n; i++) {
+            const TaskStatus_t *s = &task_status[i];
+
+            // Tasks created during the period ran only since then
+            uint32_t run = s->ulRunTimeCounter;
+            for (uint32_t j = 0; j < prev_count; j++) {
+                if (prev[j].handle == s->xHandle) {
+                    run -= prev[j].run_time_us;
+                    break;
+                }
+            }
+
+            UBaseType_t aff = vTaskCoreAffinityGet(s->xHandle) & ((1 << TELEMETRY_CORES) - 1);
+            uint32_t pm = permille(run, elapsed);
+            printf("tm task name=%s prio=%lu aff=0x%lx cpu=%lu.%lu stack_free=%lu\n",
+                   s->pcTaskName,
+                   (unsigned long)s->uxCurrentPriority,
+                   (unsigned long)aff,
+                   (unsigned long)(pm / 10), (unsigned long)(pm % 10),
+                   (unsigned long)(s->usStackHighWaterMark * sizeof(StackType_t)));
+        }
+    }
+}
+
+/**
+ * @brief Read the state of all tasks into task_status[] and keep their run time counters
+ * @return Number of tasks, 0 if there are more than TELEMETRY_MAX_TASKS
+ */
+static uint32_t take_snapshot(void)
+{
+    uint32_t n = uxTaskGetSystemState(task_status, TELEMETRY_MAX_TASKS, NULL);
+    for (uint32_t i = 0; i < n; i++) {
+        task_prev[i].handle = task_status[i].xHandle;
+        task_prev[i].run_time_us = task_status[i].ulRunTimeCounter;
+    }
+    task_prev_count = n;
+    return n;
+}
+
+/**
+ * @brief Remember the idle tasks (one per core) for the context switch hook
+ * @param n Number of tasks in task_status[]
+ * @note Found by name (configIDLE_TASK_NAME, followed by the core number on SMP kernels)
+ */
+static void find_idle_tasks(uint32_t n)
+{
+    uint32_t found = 0;
+    size_t len = strlen(configIDLE_TASK_NAME);
+
+    for (uint32_t i = 0; i < n && found < TELEMETRY_CORES; i++) {
+        if (strncmp(task_status[i].pcTaskName, configIDLE_TASK_NAME, len) == 0) {
+            idle_tasks[found++] = task_status[i].xHandle;
+        }
+    }
+}
+
+/**
+ * @brief Idle time of a core since boot, including the idle period in progress
+ * @param core Core number
+ * @param now time_us_32()
+ * @return Idle time [us], wraps
+ * @note Reads the other core's hook state without a lock, a switch at the same moment
+ *       moves a few microseconds into the next report
+ */
+static uint32_t core_idle_us(uint32_t core, uint32_t now)
+{
+    uint32_t idle = core_idle_total_us[core];
+    if (core_in_idle[core]) {
+        idle += now - core_switch_us[core];
+    }
+    return idle;
+}
+
+/**
+ * @brief Share in tenths of a percent, printed as percent with one decimal
+ * @param part Part
+ * @param whole Whole
+ * @return part * 1000 / whole, 0 if whole is 0
+ */
+static uint32_t permille(uint32_t part, uint32_t whole)
+{
+    return (whole > 0) ? (uint32_t)((uint64_t)part * 1000 / whole) : 0;
+}
+
+#endif /*TELEMETRY_ENABLE*/
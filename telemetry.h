@@ -0,0 +1,73 @@
+/**
+ * @file telemetry.h
+ * @brief Run-time telemetry: CPU load per core and per task, stack high-water marks,
+ *        FreeRTOS heap and LVGL memory, printed periodically over stdio
+ * @note Included by FreeRTOSConfig.h (run time counter and context switch hook), so it
+ *       must not include FreeRTOS, LVGL or SDK headers
+ * @author NIGHT
+ * @date 2025-10-27
+ */
+
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdint.h>
+
+/*********************
+ *      DEFINES
+ *********************/
+/* Collect and print telemetry. Also turns on FreeRTOS run time stats and stack overflow checks */
+#ifndef TELEMETRY_ENABLE
+#define TELEMETRY_ENABLE            0
+#endif
+
+/* Report period [ms] */
+#ifndef TELEMETRY_PERIOD_MS
+#define TELEMETRY_PERIOD_MS         5000
+#endif
+
+/* Most tasks reported. With more tasks the report has a "tm err" line instead of the task lines */
+#ifndef TELEMETRY_MAX_TASKS
+#define TELEMETRY_MAX_TASKS         16
+#endif
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+/**
+ * @brief Create the telemetry task (core 0, lowest priority)
+ * @note Call before vTaskStartScheduler()
+ */
+void telemetry_init(void);
+
+/**
+ * @brief Take the LVGL memory sample for the next report (LVGL task)
+ * @note Cheap unless a sample is due. lv_mem_monitor() walks the LVGL heap, so it must
+ *       run in the task that owns LVGL
+ */
+void telemetry_lvgl_sample(void);
+
+/**
+ * @brief Microsecond timer as FreeRTOS run time counter (portGET_RUN_TIME_COUNTER_VALUE)
+ * @return time_us_32()
+ */
+uint32_t telemetry_run_time_us(void);
+
+/**
+ * @brief Context switch hook (traceTASK_SWITCHED_IN), accounts idle time per core
+ * @note Called by the kernel on the core that switches, with the scheduler locked
+ */
+void telemetry_task_switched_in(void);
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /*TELEMETRY_H*/
@@ -0,0 +1,181 @@
+/**
+ * @file test_touch_filter.c
+ * @brief Host test of the 1-euro touch filter (touch_filter.c) on synthetic GT911 traces
+ * @note Traces are sampled at the GT911 report interval (5 ms) with the default parameters
+ *       of lv_port_indev.h. Noise is a fixed pseudo-random sequence, so the results are the
+ *       same on every run
+ * @author NIGHT
+ * @date 2025-10-27
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "touch_filter.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+/*********************
+ *      DEFINES
+ *********************/
+#define SAMPLE_US               5000    // GT911 report interval
+#define NOISE_PX                2       // Raw jitter of a resting finger, +-px
+#define SETTLE_SAMPLES          40      // Skipped before measuring jitter (200 ms)
+
+/* Still finger: output jitter (RMS) at most this share of the raw jitter */
+#define MAX_JITTER_RATIO        0.6     // With prediction (it extrapolates noise a little)
+#define MAX_JITTER_RATIO_NOPRED 0.3     // Filter alone
+
+/* Swipe: output behind the finger by at most this many samples */
+#define SWIPE_PX_PER_SAMPLE     5       // 1000 px/s
+#define SWIPE_SAMPLES           100
+#define MAX_LAG_SAMPLES         3       // Whole swipe, while the velocity estimate builds up
+#define MAX_LAG_SAMPLES_STEADY  1       // After SETTLE_SAMPLES
+#define MAX_LAG_SAMPLES_NOPRED  4       // Filter alone
+
+#define CHECK(cond, ...)                                            \
+    do {                                                            \
+        if (!(cond)) {                                              \
+            printf("FAIL %s:%d: ", __FILE__, __LINE__);             \
+            printf(__VA_ARGS__);                                    \
+            printf("\n");                                           \
+            failures++;                                             \
+        }                                                           \
+    } while (0)
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+/* Same values as LV_PORT_INDEV_FILTER_* / LV_PORT_INDEV_PREDICT_* in lv_port_indev.h */
+static const touch_filter_cfg_t cfg_default = {
+    .min_cutoff = 1.5f,
+    .beta = 0.01f,
+    .d_cutoff = 1.0f,
+    .predict_ms = 16,
+    .predict_max_px = 24,
+};
+
+static uint32_t noise_seed;
+static int failures = 0;
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+/**
+ * @brief Pseudo-random jitter (LCG)
+ * @return Integer in [-NOISE_PX, NOISE_PX]
+ */
+static int noise(void)
+{
+    noise_seed = noise_seed * 1664525u + 1013904223u;
+    return (int)((noise_seed >> 16) % (2 * NOISE_PX + 1)) - NOISE_PX;
+}
+
+/**
+ * @brief Finger resting on one point: the filter must remove most of the jitter
+ * @param cfg Filter parameters
+ * @param max_ratio Largest allowed output RMS / raw RMS
+ */
+static void test_still(const touch_filter_cfg_t *cfg, double max_ratio)
+{
+    const int16_t x0 = 160, y0 = 240;
+    touch_filter_t f;
+    uint32_t t = 1000;
+    double raw_sq = 0.0, out_sq = 0.0;
+
+    noise_seed = 1;
+    touch_filter_start(&f, cfg, x0, y0, t);
+
+    for (int i = 1; i <= SETTLE_SAMPLES + 200; i++) {
+        t += SAMPLE_US;
+        int16_t rx = x0 + noise();
+        int16_t ry = y0 + noise();
+        int16_t ox, oy;
+        touch_filter_update(&f, rx, ry, t, &ox, &oy);
+
+        if (i > SETTLE_SAMPLES) {
+            raw_sq += (rx - x0) * (rx - x0) + (ry - y0) * (ry - y0);
+            out_sq += (ox - x0) * (ox - x0) + (oy - y0) * (oy - y0);
+        }
+    }
+
+    double ratio = sqrt(out_sq / raw_sq);
+    printf("still (predict %u ms): jitter %.2f of raw\n", (unsigned)cfg->predict_ms, ratio);
+    CHECK(ratio <= max_ratio, "jitter ratio %.2f > %.2f", ratio, max_ratio);
+}
+
+/**
+ * @brief Fast swipe with jitter: the output may trail the finger by a few samples only
+ * @param cfg Filter parameters
+ * @param max_lag Largest allowed lag over the whole swipe [samples]
+ * @param max_lag_steady Largest allowed lag after SETTLE_SAMPLES [samples]
+ */
+static void test_swipe(const touch_filter_cfg_t *cfg, double max_lag, double max_lag_steady)
+{
+    const int16_t y0 = 240;
+    touch_filter_t f;
+    uint32_t t = 1000;
+    double worst = 0.0, worst_steady = 0.0, lead = 0.0;
+
+    noise_seed = 2;
+    touch_filter_start(&f, cfg, 0, y0, t);
+
+    for (int i = 1; i <= SWIPE_SAMPLES; i++) {
+        t += SAMPLE_US;
+        int16_t finger = i * SWIPE_PX_PER_SAMPLE;
+        int16_t ox, oy;
+        touch_filter_update(&f, finger + noise(), y0 + noise(), t, &ox, &oy);
+
+        // Positive: behind the finger, negative: ahead of it (prediction)
+        double lag = (double)(finger - ox) / SWIPE_PX_PER_SAMPLE;
+        worst = fmax(worst, lag);
+        if (i > SETTLE_SAMPLES) {
+            worst_steady = fmax(worst_steady, lag);
+        }
+        lead = fmax(lead, ox - finger);
+    }
+
+    printf("swipe (predict %u ms): lag %.1f samples, %.1f after settling, lead %.0f px\n",
+           (unsigned)cfg->predict_ms, worst, worst_steady, lead);
+    CHECK(worst <= max_lag, "lag %.1f > %.1f samples", worst, max_lag);
+    CHECK(worst_steady <= max_lag_steady, "steady lag %.1f > %.1f samples",
+          worst_steady, max_lag_steady);
+    // Prediction is capped, only the jitter can add to it
+    CHECK(lead <= cfg->predict_max_px + NOISE_PX + 1, "lead %.0f px past the prediction cap", lead);
+}
+
+/**
+ * @brief A repeated report (same timestamp) must not move the output
+ */
+static void test_repeat(void)
+{
+    touch_filter_t f;
+    int16_t ox1, oy1, ox2, oy2;
+
+    touch_filter_start(&f, &cfg_default, 100, 100, 1000);
+    touch_filter_update(&f, 110, 120, 1000 + SAMPLE_US, &ox1, &oy1);
+    touch_filter_update(&f, 200, 300, 1000 + SAMPLE_US, &ox2, &oy2);
+
+    CHECK(ox1 == ox2 && oy1 == oy2, "repeat moved (%d,%d) -> (%d,%d)", ox1, oy1, ox2, oy2);
+}
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+int main(void)
+{
+    touch_filter_cfg_t cfg_nopred = cfg_default;
+    cfg_nopred.predict_ms = 0;
+
+    test_still(&cfg_default, MAX_JITTER_RATIO);
+    test_still(&cfg_nopred, MAX_JITTER_RATIO_NOPRED);
+    test_swipe(&cfg_default, MAX_LAG_SAMPLES, MAX_LAG_SAMPLES_STEADY);
+    test_swipe(&cfg_nopred, MAX_LAG_SAMPLES_NOPRED, MAX_LAG_SAMPLES_NOPRED);
+    test_repeat();
+
+    printf("%s\n", failures ? "FAILED" : "OK");
+    return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,213 @@
+#!/usr/bin/env python3
+"""
+@file font_subset.py
+@brief Subset an LVGL font C file (lv_font_conv output) to the characters the firmware uses
+@note Usage: font_subset.py <input.c> <output.c> --sources main.c ... [--extra " 0123456789"]
+      Keeps every character that appears in a string or character literal of the sources,
+      the --extra characters and all symbols (LV_SYMBOL_*, U+F000 and up) since widgets use
+      them internally. The output defines the same lv_font_t, its glyphs are looked up
+      through the glyph cache of lv_port_font.c. Called by CMake (add_font_subset()) at build time.
+@author NIGHT
+@date 2025-10-27
+"""
+
+import argparse
+import os
+import re
+import sys
+
+SYMBOL_START = 0xF000   # FontAwesome range of LV_SYMBOL_*
+
+LITERAL_RE = re.compile(r'"((?:[^"\\\n]|\\.)*)"|\'((?:[^\'\\\n]|\\.)+)\'')
+ESCAPES = {'n': '\n', 't': '\t', 'r': '\r', '0': '\0', '\\': '\\', '"': '"', "'": "'"}
+
+
+def used_chars(paths):
+    """Characters of the string and character literals of C sources (#include lines skipped)"""
+    chars = set()
+    for path in paths:
+        text = open(path, encoding='utf-8').read()
+        text = re.sub(r'/\*.*?\*/', ' ', text, flags=re.S)
+        text = re.sub(r'//[^\n]*', '', text)
+        text = re.sub(r'^\s*#\s*include[^\n]*', '', text, flags=re.M)
+        for m in LITERAL_RE.finditer(text):
+            s = m.group(1) if m.group(1) is not None else m.group(2)
+            # \xNN sequences are the UTF-8 bytes of LV_SYMBOL_* (kept anyway), drop them
+            s = re.sub(r'\\x[0-9a-fA-F]+', '', s)
+            s = re.sub(r'\\(.)', lambda e: ESCAPES.get(e.group(1), ''), s)
+            chars.update(c for c in s if ord(c) >= 0x20)
+    return chars
+
+
+def array_body(text, name):
+    """Text between the braces of 'name[] = {' ... '};'"""
+    m = re.search(r'\b%s\[\]\s*=\s*\{(.*?)\};' % name, text, re.S)
+    return m.group(1) if m else None
+
+
+def ints(body):
+    return [int(v, 0) for v in re.findall(r'-?(?:0x[0-9a-fA-F]+|\d+)', re.sub(r'/\*.*?\*/', '', body, flags=re.S))]
+
+
+def field(text, name):
+    m = re.search(r'\.%s\s*=\s*([^,\s/]+)' % name, text)
+    if not m:
+        sys.exit('font_subset.py: .%s not found' % name)
+    return m.group(1)
+
+
+def parse(text):
+    """Glyphs (codepoint, bitmap bytes, dsc) in glyph id order, kerning and font metrics"""
+    body = array_body(text, 'glyph_bitmap')
+    parts = re.split(r'/\*\s*U\+([0-9A-Fa-f]+)[^\n]*?\*/', body)
+    codes = [int(c, 16) for c in parts[1::2]]
+    bitmaps = [bytes(ints(b)) for b in parts[2::2]]
+
+    dscs = [dict((k, int(v)) for k, v in re.findall(r'\.(\w+)\s*=\s*(-?\d+)', d))
+            for d in re.findall(r'\{(\.bitmap_index[^}]*)\}', array_body(text, 'glyph_dsc'))]
+    if len(dscs) != len(codes) + 1:
+        sys.exit('font_subset.py: %d glyph descriptors for %d bitmaps' % (len(dscs), len(codes)))
+    glyphs = [(code, bitmap, dsc) for code, bitmap, dsc in zip(codes, bitmaps, dscs[1:])]
+
+    kern = None
+    if '.kern_classes = 1' in text:
+        kern = {
+            'left': ints(array_body(text, 'kern_left_class_mapping')),
+            'right': ints(array_body(text, 'kern_right_class_mapping')),
+            'values': array_body(text, 'kern_class_values').strip(),
+            'values_type': re.search(r'(\w+)\s+kern_class_values\[\]', text).group(1),
+            'left_cnt': field(text, 'left_class_cnt'),
+            'right_cnt': field(text, 'right_class_cnt'),
+            'scale': field(text, 'kern_scale'),
+        }
+    elif '.kern_dsc = NULL' not in text:
+        sys.exit('font_subset.py: only class based kerning (--force-fast-kern-format) is supported')
+
+    metrics = dict((name, field(text, name)) for name in
+                   ('bpp', 'bitmap_format', 'line_height', 'base_line', 'subpx',
+                    'underline_position', 'underline_thickness'))
+    metrics['cache'] = '.cache = &cache' in text
+    return glyphs, kern, metrics
+
+
+def c_array(values, per_line=16):
+    return '\n'.join('    ' + ', '.join(values[i:i + per_line]) + ','
+                     for i in range(0, len(values), per_line))
+
+
+def write_c(path, name, glyphs, kern, metrics, report):
+    codes = [g[0] for g in glyphs]
+    with open(path, 'w') as f:
+        f.write('/**\n')
+        f.write(' * @file %s\n' % os.path.basename(path))
+        f.write(' * @brief %s subset, generated by tools/font_subset.py - do not edit\n' % name)
+        f.write(' * @note %s\n' % report)
+        f.write(' */\n\n')
+        f.write('#include "lv_port_font.h"\n\n')
+
+        f.write('static LV_ATTRIBUTE_LARGE_CONST const uint8_t glyph_bitmap[] = {\n')
+        for code, bitmap, _ in glyphs:
+            f.write('    /* U+%04X */\n' % code)
+            if bitmap:
+                f.write(c_array(['0x%02x' % b for b in bitmap]) + '\n')
+        f.write('};\n\n')
+
+        f.write('static const lv_font_fmt_txt_glyph_dsc_t glyph_dsc[] = {\n')
+        f.write('    {.bitmap_index = 0, .adv_w = 0, .box_w = 0, .box_h = 0, .ofs_x = 0, .ofs_y = 0} /* id = 0 reserved */,\n')
+        index = 0
+        for _, bitmap, d in glyphs:
+            f.write('    {.bitmap_index = %d, .adv_w = %d, .box_w = %d, .box_h = %d, .ofs_x = %d, .ofs_y = %d},\n' % (
+                index, d['adv_w'], d['box_w'], d['box_h'], d['ofs_x'], d['ofs_y']))
+            index += len(bitmap)
+        f.write('};\n\n')
+
+        # One sparse map: glyph id i + 1 is the i-th code, offsets relative to the first
+        f.write('static const uint16_t unicode_list[] = {\n')
+        f.write(c_array(['0x%x' % (c - codes[0]) for c in codes], 12) + '\n')
+        f.write('};\n\n')
+        f.write('static const lv_font_fmt_txt_cmap_t cmaps[] = {\n')
+        f.write('    {\n')
+        f.write('        .range_start = %d, .range_length = %d, .glyph_id_start = 1,\n' % (
+            codes[0], codes[-1] - codes[0] + 1))
+        f.write('        .unicode_list = unicode_list, .glyph_id_ofs_list = NULL, .list_length = %d,\n' % len(codes))
+        f.write('        .type = LV_FONT_FMT_TXT_CMAP_SPARSE_TINY\n')
+        f.write('    }\n')
+        f.write('};\n\n')
+
+        if kern:
+            f.write('static const uint8_t kern_left_class_mapping[] = {\n')
+            f.write(c_array(['%d' % v for v in kern['left_map']]) + '\n')
+            f.write('};\n\n')
+            f.write('static const uint8_t kern_right_class_mapping[] = {\n')
+            f.write(c_array(['%d' % v for v in kern['right_map']]) + '\n')
+            f.write('};\n\n')
+            f.write('static const %s kern_class_values[] = {\n    %s\n};\n\n' % (kern['values_type'], kern['values']))
+            f.write('static const lv_font_fmt_txt_kern_classes_t kern_classes = {\n')
+            f.write('    .class_pair_values = kern_class_values,\n')
+            f.write('    .left_class_mapping = kern_left_class_mapping,\n')
+            f.write('    .right_class_mapping = kern_right_class_mapping,\n')
+            f.write('    .left_class_cnt = %s,\n' % kern['left_cnt'])
+            f.write('    .right_class_cnt = %s,\n' % kern['right_cnt'])
+            f.write('};\n\n')
+
+        if metrics['cache']:
+            f.write('static lv_font_fmt_txt_glyph_cache_t cache;\n\n')
+        f.write('static const lv_font_fmt_txt_dsc_t font_dsc = {\n')
+        f.write('    .glyph_bitmap = glyph_bitmap,\n')
+        f.write('    .glyph_dsc = glyph_dsc,\n')
+        f.write('    .cmaps = cmaps,\n')
+        f.write('    .kern_dsc = %s,\n' % ('&kern_classes' if kern else 'NULL'))
+        f.write('    .kern_scale = %s,\n' % (kern['scale'] if kern else '0'))
+        f.write('    .cmap_num = 1,\n')
+        f.write('    .bpp = %s,\n' % metrics['bpp'])
+        f.write('    .kern_classes = %d,\n' % (1 if kern else 0))
+        f.write('    .bitmap_format = %s,\n' % metrics['bitmap_format'])
+        if metrics['cache']:
+            f.write('    .cache = &cache\n')
+        f.write('};\n\n')
+
+        f.write('const lv_font_t %s = {\n' % name)
+        f.write('    .get_glyph_dsc = lv_port_font_get_glyph_dsc,\n')
+        f.write('    .get_glyph_bitmap = lv_port_font_get_glyph_bitmap,\n')
+        for key in ('line_height', 'base_line', 'subpx', 'underline_position', 'underline_thickness'):
+            f.write('    .%s = %s,\n' % (key, metrics[key]))
+        f.write('    .dsc = &font_dsc\n')
+        f.write('};\n')
+
+
+def main():
+    ap = argparse.ArgumentParser(description='Subset an LVGL font C file to the characters used by the firmware')
+    ap.add_argument('input', help='LVGL font C file (lv_font_conv --format lvgl)')
+    ap.add_argument('output', help='Output C file')
+    ap.add_argument('--sources', nargs='+', default=[], help='C files whose literals are scanned')
+    ap.add_argument('--extra', default='', help='Characters kept in addition (e.g. printf output)')
+    args = ap.parse_args()
+
+    text = open(args.input, encoding='utf-8').read()
+    name = re.search(r'\blv_font_t\s+(\w+)\s*=', text).group(1)
+    glyphs, kern, metrics = parse(text)
+
+    keep = set(ord(c) for c in used_chars(args.sources) | set(args.extra))
+    ids = [i for i, (code, _, _) in enumerate(glyphs) if code in keep or code >= SYMBOL_START]
+    missing = sorted(keep - set(g[0] for g in glyphs))
+    if not ids:
+        sys.exit('%s: no glyph left' % args.input)
+
+    if kern:
+        # Class mappings are indexed by glyph id, id 0 is reserved
+        kern['left_map'] = [0] + [kern['left'][i + 1] for i in ids]
+        kern['right_map'] = [0] + [kern['right'][i + 1] for i in ids]
+    subset = [glyphs[i] for i in ids]
+
+    before = sum(len(g[1]) for g in glyphs)
+    after = sum(len(g[1]) for g in subset)
+    report = '%s: %d of %d glyphs, %d bytes of bitmaps (full font %d bytes)' % (
+        name, len(subset), len(glyphs), after, before)
+    if missing:
+        report += ', not in the font: %s' % ' '.join('U+%04X' % c for c in missing)
+    write_c(args.output, name, subset, kern, metrics, report)
+    print(report)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,249 @@
+#!/usr/bin/env python3
+"""
+@file img_conv.py
+@brief Convert a PNG into an LVGL image C file in the display's native pixel format
+@note Usage: img_conv.py <input.png> <name> <output.c> --depth 16 --swap 0 [--compress rle565|index8]
+      Only the format selected by --depth/--swap (LV_COLOR_DEPTH/LV_COLOR_16_SWAP of lv_conf.h)
+      is emitted, so the image needs no conversion or byte swapping at run time.
+      Called by CMake (add_image_asset()) at build time.
+@author NIGHT
+@date 2025-10-27
+"""
+
+import argparse
+import collections
+import os
+import struct
+import sys
+import zlib
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+import img_rle  # noqa: E402
+
+KMEANS_ROUNDS = 4  # Palette refinement after the median cut (index8)
+
+
+def read_png(path):
+    """8-bit RGB, RGBA, gray or gray+alpha PNG, not interlaced. Returns (w, h, [(r, g, b, a)])."""
+    data = open(path, 'rb').read()
+    if data[:8] != b'\x89PNG\r\n\x1a\n':
+        sys.exit('%s: not a PNG file' % path)
+
+    pos = 8
+    idat = bytearray()
+    w = h = depth = ctype = interlace = None
+    while pos < len(data):
+        length, tag = struct.unpack('>I4s', data[pos:pos + 8])
+        body = data[pos + 8:pos + 8 + length]
+        if tag == b'IHDR':
+            w, h, depth, ctype, _, _, interlace = struct.unpack('>IIBBBBB', body)
+        elif tag == b'IDAT':
+            idat += body
+        elif tag == b'IEND':
+            break
+        pos += 12 + length
+
+    channels = {0: 1, 2: 3, 4: 2, 6: 4}.get(ctype)
+    if depth != 8 or channels is None or interlace != 0:
+        sys.exit('%s: only 8-bit gray/RGB/RGBA PNGs without interlacing are supported' % path)
+
+    raw = zlib.decompress(bytes(idat))
+    stride = w * channels
+    prev = bytearray(stride)
+    pixels = []
+    pos = 0
+    for _ in range(h):
+        ftype = raw[pos]
+        line = bytearray(raw[pos + 1:pos + 1 + stride])
+        pos += 1 + stride
+        for i in range(stride):
+            a = line[i - channels] if i >= channels else 0
+            b = prev[i]
+            c = prev[i - channels] if i >= channels else 0
+            if ftype == 1:
+                line[i] = (line[i] + a) & 0xFF
+            elif ftype == 2:
+                line[i] = (line[i] + b) & 0xFF
+            elif ftype == 3:
+                line[i] = (line[i] + ((a + b) >> 1)) & 0xFF
+            elif ftype == 4:
+                p = a + b - c
+                pa, pb, pc = abs(p - a), abs(p - b), abs(p - c)
+                pred = a if pa <= pb and pa <= pc else (b if pb <= pc else c)
+                line[i] = (line[i] + pred) & 0xFF
+        for x in range(w):
+            px = line[x * channels:(x + 1) * channels]
+            if channels == 1:
+                pixels.append((px[0], px[0], px[0], 255))
+            elif channels == 2:
+                pixels.append((px[0], px[0], px[0], px[1]))
+            elif channels == 3:
+                pixels.append((px[0], px[1], px[2], 255))
+            else:
+                pixels.append(tuple(px))
+        prev = line
+    return w, h, pixels
+
+
+def to_rgb565(pixels):
+    """RGB565 values, rounded to the nearest level"""
+    return [(((r * 31 + 127) // 255) << 11) | (((g * 63 + 127) // 255) << 5) | ((b * 31 + 127) // 255)
+            for r, g, b, _ in pixels]
+
+
+def quantize(colors):
+    """Median cut of RGB565 values to at most 256 colors. Returns (palette, index per pixel)."""
+    counts = collections.Counter(colors)
+
+    def channels(c):
+        # Components scaled to a common 0..63 range so the cut picks the widest one fairly
+        return ((c >> 11) << 1, (c >> 5) & 0x3F, (c & 0x1F) << 1)
+
+    def error(box):
+        # Squared distance of the pixels to the box mean, the box that gains most from a cut
+        n = sum(counts[c] for c in box)
+        mean = [sum(channels(c)[i] * counts[c] for c in box) / n for i in range(3)]
+        return sum(counts[c] * sum((channels(c)[i] - mean[i]) ** 2 for i in range(3)) for c in box)
+
+    boxes = [list(counts)]
+    errors = [error(boxes[0])]
+    while len(boxes) < 256:
+        # Split the box with the largest error among those with more than one color
+        splittable = [i for i, b in enumerate(boxes) if len(b) > 1]
+        if not splittable:
+            break
+        i = max(splittable, key=lambda i: errors[i])
+        box = boxes.pop(i)
+        errors.pop(i)
+
+        spans = [max(channels(c)[i] for c in box) - min(channels(c)[i] for c in box) for i in range(3)]
+        axis = spans.index(max(spans))
+        box.sort(key=lambda c: channels(c)[axis])
+
+        # Weighted median, keeping at least one color on each side
+        half = sum(counts[c] for c in box) / 2.0
+        acc = 0
+        cut = 1
+        for i, c in enumerate(box[:-1]):
+            acc += counts[c]
+            if acc >= half:
+                cut = i + 1
+                break
+        boxes += [box[:cut], box[cut:]]
+        errors += [error(box[:cut]), error(box[cut:])]
+
+    # A few k-means rounds: every color moves to its nearest entry, entries move to their mean
+    for _ in range(KMEANS_ROUNDS):
+        palette = []
+        for box in boxes:
+            n = sum(counts[c] for c in box)
+            r = sum((c >> 11) * counts[c] for c in box)
+            g = sum(((c >> 5) & 0x3F) * counts[c] for c in box)
+            b = sum((c & 0x1F) * counts[c] for c in box)
+            palette.append((((r + n // 2) // n) << 11) | (((g + n // 2) // n) << 5) | ((b + n // 2) // n))
+        entries = [channels(p) for p in palette]
+        lookup = {}
+        for c in counts:
+            cr, cg, cb = channels(c)
+            lookup[c] = min(range(len(entries)), key=lambda i: (entries[i][0] - cr) ** 2 +
+                            (entries[i][1] - cg) ** 2 + (entries[i][2] - cb) ** 2)
+        boxes = [[] for _ in palette]
+        for c, i in lookup.items():
+            boxes[i].append(c)
+        boxes = [b for b in boxes if b]
+    return palette, [lookup[c] for c in colors]
+
+
+def to_native(pixels, depth, swap, alpha):
+    """Pixel bytes exactly as lv_color_t (followed by the alpha byte for *_ALPHA formats)"""
+    out = bytearray()
+    if depth == 16:
+        for px, (_, _, _, a) in zip(to_rgb565(pixels), pixels):
+            out += struct.pack('>H' if swap else '<H', px)
+            if alpha:
+                out.append(a)
+    elif depth == 8:
+        for r, g, b, a in pixels:
+            out.append((r & 0xE0) | ((g >> 3) & 0x1C) | (b >> 6))
+            if alpha:
+                out.append(a)
+    else:
+        for r, g, b, a in pixels:
+            out += bytes((b, g, r, a if alpha else 0xFF))
+    return out
+
+
+def write_c(path, name, blob, w, h, cf, fmt, report, guard, encoded):
+    with open(path, 'w') as f:
+        f.write('/**\n')
+        f.write(' * @file %s\n' % os.path.basename(path))
+        f.write(' * @brief %s: %dx%d %s, generated by tools/img_conv.py - do not edit\n' % (name, w, h, fmt))
+        f.write(' * @note %s\n' % report)
+        f.write(' */\n\n')
+        if encoded:
+            f.write('#include "lv_port_img.h"\n\n')
+        else:
+            f.write('#if defined(LV_LVGL_H_INCLUDE_SIMPLE)\n#include "lvgl.h"\n#else\n#include "lvgl/lvgl.h"\n#endif\n\n')
+        f.write('#if %s\n' % guard)
+        f.write('#error "%s was converted for another LV_COLOR_DEPTH/LV_COLOR_16_SWAP, rerun CMake"\n' % name)
+        f.write('#endif\n\n')
+        f.write('static const uint8_t %s_map[] __attribute__((aligned(4))) = {\n' % name)
+        for i in range(0, len(blob), 16):
+            f.write('  ' + ', '.join('0x%02x' % b for b in blob[i:i + 16]) + ',\n')
+        f.write('};\n\n')
+        f.write('const lv_img_dsc_t %s = {\n' % name)
+        f.write('  .header.cf = %s,\n' % cf)
+        f.write('  .header.always_zero = 0,\n')
+        f.write('  .header.reserved = 0,\n')
+        f.write('  .header.w = %d,\n' % w)
+        f.write('  .header.h = %d,\n' % h)
+        f.write('  .data_size = sizeof(%s_map),\n' % name)
+        f.write('  .data = %s_map,\n' % name)
+        f.write('};\n')
+
+
+def main():
+    ap = argparse.ArgumentParser(description='Convert a PNG into a display-native LVGL image C file')
+    ap.add_argument('input', help='PNG file')
+    ap.add_argument('name', help='C name of the lv_img_dsc_t')
+    ap.add_argument('output', help='Output C file')
+    ap.add_argument('--depth', type=int, choices=(8, 16, 32), required=True, help='LV_COLOR_DEPTH')
+    ap.add_argument('--swap', type=int, choices=(0, 1), default=0, help='LV_COLOR_16_SWAP')
+    ap.add_argument('--compress', choices=('none', 'rle565', 'index8'), default='none')
+    args = ap.parse_args()
+
+    w, h, pixels = read_png(args.input)
+    alpha = any(a != 255 for _, _, _, a in pixels)
+    raw_size = w * h * (args.depth // 8 + (1 if alpha and args.depth != 32 else 0))
+
+    if args.compress == 'rle565':
+        if args.depth != 16 or alpha:
+            sys.exit('%s: RLE565 needs LV_COLOR_DEPTH 16 and an opaque image' % args.input)
+        # Encoded unswapped, lv_port_img.c writes the pixels in LV_COLOR_16_SWAP order
+        blob = img_rle.encode(to_rgb565(pixels), w, h)
+        cf, fmt = 'LV_PORT_IMG_CF_RLE565', 'RLE565'
+    elif args.compress == 'index8':
+        if args.depth != 16 or alpha:
+            sys.exit('%s: index8 needs LV_COLOR_DEPTH 16 and an opaque image' % args.input)
+        palette, indices = quantize(to_rgb565(pixels))
+        palette += [0] * (256 - len(palette))
+        # Palette in lv_color_t byte order, the indices expand without any conversion
+        blob = struct.pack(('>%dH' if args.swap else '<%dH') % 256, *palette) + bytes(indices)
+        cf, fmt = 'LV_PORT_IMG_CF_I8_565', 'I8_565 (%d colors)' % len(set(indices))
+    else:
+        blob = to_native(pixels, args.depth, args.swap, alpha)
+        cf = 'LV_IMG_CF_TRUE_COLOR_ALPHA' if alpha else 'LV_IMG_CF_TRUE_COLOR'
+        fmt = '%s %d-bit%s' % ('true color alpha' if alpha else 'true color', args.depth,
+                               ' swapped' if args.depth == 16 and args.swap else '')
+
+    guard = 'LV_COLOR_DEPTH != %d' % args.depth
+    if args.depth == 16 and args.compress != 'rle565':
+        guard += ' || LV_COLOR_16_SWAP != %d' % args.swap
+    report = '%s: %dx%d %s, %d bytes of flash (uncompressed %d bytes, %.1f%%)' % (
+        args.name, w, h, fmt, len(blob), raw_size, 100.0 * len(blob) / raw_size)
+    write_c(args.output, args.name, blob, w, h, cf, fmt, report, guard, args.compress != 'none')
+    print(report)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,65 @@
+"""
+@file img_rle.py
+@brief RLE565 encoder for the format decoded by lv_port_img.c
+@note Imported by img_conv.py (add_image_asset(... rle565) in CMakeLists.txt), which reads
+      the PNG and writes the image C file. This module only turns RGB565 pixels into the
+      row offset table and op stream
+@author NIGHT
+@date 2025-10-27
+"""
+
+import struct
+
+# Op codes, see lv_port_img.h
+OP_DIFF = 0x00      # 0xxxxxxx: dr (2 bits), dg (3 bits), db (2 bits) from the previous pixel
+OP_RUN = 0x80       # 10nnnnnn: previous pixel 1..64 more times
+OP_LUMA = 0xC0      # 11gggggg (dg -32..30), then (dr - dg/2, db - dg/2) as two nibbles
+OP_LITERAL = 0xFF   # 11111111, then the pixel (2 bytes, little endian)
+RUN_MAX = 64
+
+
+def split(px):
+    return (px >> 11) & 0x1F, (px >> 5) & 0x3F, px & 0x1F
+
+
+def encode_row(row):
+    """Encode one row. Rows are independent (the previous pixel starts at 0) so any row
+    can be decoded on its own."""
+    out = bytearray()
+    prev = 0
+    i = 0
+    while i < len(row):
+        px = row[i]
+        if px == prev:
+            n = 1
+            while i + n < len(row) and row[i + n] == prev and n < RUN_MAX:
+                n += 1
+            out.append(OP_RUN | (n - 1))
+            i += n
+            continue
+
+        r, g, b = split(px)
+        pr, pg, pb = split(prev)
+        dr, dg, db = r - pr, g - pg, b - pb
+        if -2 <= dr <= 1 and -4 <= dg <= 3 and -2 <= db <= 1:
+            out.append(OP_DIFF | ((dr + 2) << 5) | ((dg + 4) << 2) | (db + 2))
+        elif -32 <= dg <= 30 and -8 <= dr - (dg >> 1) <= 7 and -8 <= db - (dg >> 1) <= 7:
+            out.append(OP_LUMA | (dg + 32))
+            out.append(((dr - (dg >> 1) + 8) << 4) | (db - (dg >> 1) + 8))
+        else:
+            out.append(OP_LITERAL)
+            out += struct.pack('<H', px)
+        prev = px
+        i += 1
+    return out
+
+
+def encode(pixels, w, h):
+    """Row offset table (uint32 per row) followed by the op stream."""
+    stream = bytearray()
+    offsets = []
+    for y in range(h):
+        offsets.append(len(stream))
+        stream += encode_row(pixels[y * w:(y + 1) * w])
+    return struct.pack('<%dI' % h, *offsets) + stream
+
@@ -0,0 +1,125 @@
+/**
+ * @file touch_filter.c
+ * @brief 1-euro touch pointer filter with extrapolation to the expected display time
+ * @note 1-euro filter (Casiez et al.): the cutoff rises with speed, so slow motion is smoothed
+ *       and fast motion is followed without lag. The filtered velocity then extrapolates the
+ *       position by predict_ms, the time from the sample until the strip reaches the panel
+ * @author NIGHT
+ * @date 2025-10-27
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "touch_filter.h"
+#include <math.h>
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static float euro_alpha(float cutoff, float dt);
+static float euro_axis_update(const touch_filter_cfg_t *cfg, touch_filter_axis_t *axis,
+                              float raw, float dt);
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+/**
+ * @brief Start filtering a new touch at its first sample
+ * @param f Filter state
+ * @param cfg Parameters (copied)
+ * @param x Raw X coordinate of the touch-down
+ * @param y Raw Y coordinate of the touch-down
+ * @param t_us Sample time
+ */
+void touch_filter_start(touch_filter_t *f, const touch_filter_cfg_t *cfg,
+                        int16_t x, int16_t y, uint32_t t_us)
+{
+    f->cfg = *cfg;
+    f->ax = (touch_filter_axis_t){ .x = x, .dx = 0.0f };
+    f->ay = (touch_filter_axis_t){ .x = y, .dx = 0.0f };
+    f->t_us = t_us;
+    f->out_x = x;
+    f->out_y = y;
+}
+
+/**
+ * @brief Filter one more sample of the touch
+ * @param f Filter state
+ * @param raw_x Raw X coordinate
+ * @param raw_y Raw Y coordinate
+ * @param t_us Sample time
+ * @param out_x Output parameter: filtered and extrapolated X
+ * @param out_y Output parameter: filtered and extrapolated Y
+ */
+void touch_filter_update(touch_filter_t *f, int16_t raw_x, int16_t raw_y, uint32_t t_us,
+                         int16_t *out_x, int16_t *out_y)
+{
+    // Two reports with the same timestamp: keep the output
+    uint32_t dt_us = t_us - f->t_us;
+    if (dt_us == 0) {
+        *out_x = f->out_x;
+        *out_y = f->out_y;
+        return;
+    }
+    f->t_us = t_us;
+
+    float dt = dt_us * 1e-6f;
+    float x = euro_axis_update(&f->cfg, &f->ax, raw_x, dt);
+    float y = euro_axis_update(&f->cfg, &f->ay, raw_y, dt);
+
+    // Extrapolate to the expected display time, limited in distance
+    float lead = f->cfg.predict_ms * 1e-3f;
+    float px = f->ax.dx * lead;
+    float py = f->ay.dx * lead;
+    float max = f->cfg.predict_max_px;
+    px = px > max ? max : (px < -max ? -max : px);
+    py = py > max ? max : (py < -max ? -max : py);
+
+    f->out_x = (int16_t)lroundf(x + px);
+    f->out_y = (int16_t)lroundf(y + py);
+
+    *out_x = f->out_x;
+    *out_y = f->out_y;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+/**
+ * @brief Smoothing factor of a first order low-pass filter
+ * @param cutoff Cutoff frequency [Hz]
+ * @param dt Sample interval [s]
+ * @return alpha in (0, 1]
+ */
+static float euro_alpha(float cutoff, float dt)
+{
+    float tau = 1.0f / (2.0f * 3.14159265f * cutoff);
+    return 1.0f / (1.0f + tau / dt);
+}
+
+/**
+ * @brief 1-euro filter step for one axis
+ * @param cfg Parameters
+ * @param axis Axis state
+ * @param raw New raw position [px]
+ * @param dt Time since the previous sample [s]
+ * @return Filtered position [px]
+ */
+static float euro_axis_update(const touch_filter_cfg_t *cfg, touch_filter_axis_t *axis,
+                              float raw, float dt)
+{
+    // 1. Velocity from the raw sample, low-pass filtered with the fixed d_cutoff
+    float dx = (raw - axis->x) / dt;
+    float a_d = euro_alpha(cfg->d_cutoff, dt);
+    axis->dx += a_d * (dx - axis->dx);
+
+    // 2. Position with a cutoff that grows with speed
+    float cutoff = cfg->min_cutoff + cfg->beta * fabsf(axis->dx);
+    float a = euro_alpha(cutoff, dt);
+    axis->x += a * (raw - axis->x);
+
+    return axis->x;
+}
